@@ -0,0 +1,178 @@
+/**
+ * @file Adjacency.cpp
+ * @brief This file contains the implementation of the functions in Adjacency.h (the compressed adjacency of the graph)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 22/1/2022
+ */
+
+#include <utility>
+#include "Adjacency.h"
+
+/**
+ * Constructor (an adjacency without nodes)
+ */
+Adjacency::Adjacency() : offsets(1, 0) {}
+
+/**
+ * Constructor, it lays out the edges grouped by their origin (counting sort), keeping the order they were given in
+ * @param nNodes This is the number of nodes of the adjacency
+ * @param edges This is the list of edges, every edge must connect nodes lower than nNodes
+ */
+Adjacency::Adjacency(unsigned nNodes, const std::vector<Edge> &edges) : offsets(nNodes + 1, 0) {
+    for (const auto &edge: edges) {
+        offsets[edge.from + 1]++;
+    }
+    for (unsigned i = 0; i < nNodes; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    targets.resize(edges.size());
+    weights.resize(edges.size());
+    lines.resize(edges.size());
+    services.resize(edges.size());
+    std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+    for (const auto &edge: edges) {
+        unsigned position = next[edge.from]++;
+        targets[position] = edge.to;
+        weights[position] = edge.weight;
+        lines[position] = edge.line;
+        services[position] = edge.services;
+    }
+}
+
+/**
+ * This method expands the adjacency back into a list of edges, it is used when the adjacency needs to be rebuilt
+ * @return The return is a vector with every edge, grouped by their origin
+ */
+std::vector<Adjacency::Edge> Adjacency::getEdges() const {
+    std::vector<Edge> edges;
+    edges.reserve(targets.size());
+    for (unsigned node = 0; node + 1 < offsets.size(); ++node) {
+        for (unsigned e = offsets[node]; e < offsets[node + 1]; ++e) {
+            edges.push_back({node, targets[e], weights[e], lines[e], services[e]});
+        }
+    }
+    return edges;
+}
+
+/**
+ * This method builds the adjacency with every edge turned around, the edges leaving a node in it are the ones that
+ * reach that node in this adjacency
+ * @return The return is the reversed adjacency, with the same nodes
+ */
+Adjacency Adjacency::reversed() const {
+    std::vector<Edge> edges = getEdges();
+    for (auto &edge: edges) {
+        std::swap(edge.from, edge.to);
+    }
+    return Adjacency(getNumberNodes(), edges);
+}
+
+/**
+ * This method adds new nodes (without edges) at the end of the adjacency
+ * @param nNodes This is the number of nodes to add
+ */
+void Adjacency::addNodes(unsigned nNodes) {
+    offsets.insert(offsets.end(), nNodes, offsets.back());
+}
+
+/**
+ * This method gets the number of nodes of the adjacency
+ * @return The return is the number of nodes
+ */
+unsigned Adjacency::getNumberNodes() const {
+    return offsets.size() - 1;
+}
+
+/**
+ * This method gets the number of edges of the adjacency
+ * @return The return is the number of edges
+ */
+unsigned Adjacency::getNumberEdges() const {
+    return targets.size();
+}
+
+/**
+ * This method gets the position of the first edge of every node
+ * @return The return is the offsets array (with one extra entry at the end)
+ */
+const std::vector<unsigned> &Adjacency::getOffsets() const {
+    return offsets;
+}
+
+/**
+ * This method gets the node every edge goes to
+ * @return The return is the targets array
+ */
+const std::vector<unsigned> &Adjacency::getTargets() const {
+    return targets;
+}
+
+/**
+ * This method gets the distance (in meters) of every edge
+ * @return The return is the weights array
+ */
+const std::vector<double> &Adjacency::getWeights() const {
+    return weights;
+}
+
+/**
+ * This method gets the interned line id of every edge
+ * @return The return is the lines array
+ */
+const std::vector<unsigned> &Adjacency::getLines() const {
+    return lines;
+}
+
+/**
+ * This method gets the service periods of every edge
+ * @return The return is the services array
+ */
+const std::vector<unsigned char> &Adjacency::getServices() const {
+    return services;
+}
+
+/**
+ * This method writes the arrays of the adjacency to a snapshot
+ * @param snapshot This is the snapshot being written
+ */
+void Adjacency::save(Snapshot &snapshot) const {
+    snapshot.putArray(offsets);
+    snapshot.putArray(targets);
+    snapshot.putArray(weights);
+    snapshot.putArray(lines);
+    snapshot.putArray(services);
+}
+
+/**
+ * This method reads the arrays of the adjacency from a snapshot written by save, the adjacency is only replaced if
+ * they are complete and consistent (every edge inside its node and going to a node of the adjacency)
+ * @param snapshot This is the mapped snapshot
+ * @return The return is true if the adjacency was read
+ */
+bool Adjacency::load(Snapshot &snapshot) {
+    Adjacency read;
+    if (!snapshot.getArray(read.offsets) || !snapshot.getArray(read.targets) || !snapshot.getArray(read.weights) ||
+        !snapshot.getArray(read.lines) || !snapshot.getArray(read.services)) {
+        return false;
+    }
+    unsigned nEdges = read.targets.size();
+    if (read.offsets.empty() || read.offsets.front() != 0 || read.offsets.back() != nEdges ||
+        read.weights.size() != nEdges || read.lines.size() != nEdges || read.services.size() != nEdges) {
+        return false;
+    }
+    for (unsigned node = 0; node + 1 < read.offsets.size(); ++node) {
+        if (read.offsets[node] > read.offsets[node + 1]) {
+            return false;
+        }
+    }
+    for (unsigned target: read.targets) {
+        if (target >= read.getNumberNodes()) {
+            return false;
+        }
+    }
+    *this = std::move(read);
+    return true;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file Adjacency.h
+ * @brief This file contains the implementation of the compressed (CSR) adjacency used by the graph and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 22/1/2022
+ */
+
+#ifndef AEDAGRAFOS_ADJACENCY_H
+#define AEDAGRAFOS_ADJACENCY_H
+
+#include <vector>
+#include "Snapshot.h"
+
+/**
+ * This is a frozen compressed sparse row (CSR) adjacency, the edges leaving the node i are stored contiguously in the
+ * positions [offsets[i], offsets[i+1]) of the targets, weights, lines and services arrays
+ * @param offsets This is the position of the first edge of every node (it has one extra entry at the end)
+ * @param targets This is the index of the node every edge goes to
+ * @param weights This is the distance in meters of every edge
+ * @param lines This is the interned id of the line (or walk) every edge belongs to
+ * @param services This is the bitmask of the service periods every edge runs in (every bit is set for the edges that
+ * are always there, like walking)
+ */
+class Adjacency {
+public:
+    /**
+     * This is an edge while the adjacency is being built
+     */
+    struct Edge {
+        unsigned from;
+        unsigned to;
+        double weight;
+        unsigned line;
+        unsigned char services = 0xFF;
+    };
+
+    Adjacency();
+
+    Adjacency(unsigned nNodes, const std::vector<Edge> &edges);
+
+    std::vector<Edge> getEdges() const;
+
+    Adjacency reversed() const;
+
+    void addNodes(unsigned nNodes);
+
+    unsigned getNumberNodes() const;
+
+    unsigned getNumberEdges() const;
+
+    const std::vector<unsigned> &getOffsets() const;
+
+    const std::vector<unsigned> &getTargets() const;
+
+    const std::vector<double> &getWeights() const;
+
+    const std::vector<unsigned> &getLines() const;
+
+    const std::vector<unsigned char> &getServices() const;
+
+    void save(Snapshot &snapshot) const;
+
+    bool load(Snapshot &snapshot);
+
+private:
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> targets;
+    std::vector<double> weights;
+    std::vector<unsigned> lines;
+    std::vector<unsigned char> services;
+};
+
+
+#endif //AEDAGRAFOS_ADJACENCY_H
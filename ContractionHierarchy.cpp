@@ -0,0 +1,441 @@
+/**
+ * @file ContractionHierarchy.cpp
+ * @brief This file contains the implementation of the functions in ContractionHierarchy.h (the contraction hierarchy)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 28/1/2022
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include "ContractionHierarchy.h"
+
+const unsigned ContractionHierarchy::NO_NODE;
+
+/**
+ * This is the number of nodes a witness search may settle before it gives up, a shortcut is added when no witness
+ * path is found (an extra shortcut only costs a little space, the queries are still exact)
+ */
+static const unsigned WITNESS_SETTLE_LIMIT = 100;
+
+/**
+ * This is the value of a distance that was not found
+ */
+static const double UNREACHED = INT32_MAX;
+
+/**
+ * This is an edge of the graph while it is being contracted
+ * @param node This is the node at the other end of the edge
+ * @param weight This is the distance in meters
+ * @param middle This is the node a shortcut skips, NO_NODE on the edges of the graph
+ */
+struct ContractionArc {
+    unsigned node;
+    double weight;
+    unsigned middle;
+};
+
+/**
+ * This is the graph while it is being contracted, every node keeps the edges that leave it and the ones that reach it
+ * @param out This is the edges leaving every node
+ * @param in This is the edges reaching every node
+ * @param contracted This marks the nodes that were already contracted
+ * @param deletedNeighbours This is the number of neighbours of every node that were already contracted
+ * @param witnessDistance This is the distance of every node found by the last witness search
+ * @param touched This is the nodes the last witness search reached
+ * @param heap This is the priority queue of the witness search
+ */
+struct ContractionGraph {
+    std::vector<std::vector<ContractionArc>> out;
+    std::vector<std::vector<ContractionArc>> in;
+    std::vector<char> contracted;
+    std::vector<unsigned> deletedNeighbours;
+    std::vector<double> witnessDistance;
+    std::vector<unsigned> touched;
+    std::vector<std::pair<double, unsigned>> heap;
+
+    /**
+     * Constructor (a graph without edges)
+     * @param nNodes This is the number of nodes
+     */
+    explicit ContractionGraph(unsigned nNodes) : out(nNodes), in(nNodes), contracted(nNodes, false),
+                                                 deletedNeighbours(nNodes, 0), witnessDistance(nNodes, UNREACHED) {}
+
+    /**
+     * This method adds an edge, if there is already an edge between the same nodes only the shortest one is kept
+     * @param from This is the node the edge leaves
+     * @param to This is the node the edge reaches
+     * @param weight This is the distance in meters
+     * @param middle This is the node a shortcut skips, NO_NODE on the edges of the graph
+     */
+    void addArc(unsigned from, unsigned to, double weight, unsigned middle) {
+        if (from == to) {
+            return;
+        }
+        for (auto &arc: out[from]) {
+            if (arc.node == to) {
+                if (arc.weight <= weight) {
+                    return;
+                }
+                arc.weight = weight;
+                arc.middle = middle;
+                for (auto &back: in[to]) {
+                    if (back.node == from) {
+                        back.weight = weight;
+                        back.middle = middle;
+                    }
+                }
+                return;
+            }
+        }
+        out[from].push_back({to, weight, middle});
+        in[to].push_back({from, weight, middle});
+    }
+
+    /**
+     * This method finds the distances from a node to the nodes around it without going through the node being
+     * contracted (a witness path makes a shortcut unnecessary)
+     * @param source This is the node the search starts at
+     * @param skip This is the node being contracted
+     * @param maxDistance This is the longest distance that is worth looking at
+     */
+    void witnessSearch(unsigned source, unsigned skip, double maxDistance) {
+        for (unsigned node: touched) {
+            witnessDistance[node] = UNREACHED;
+        }
+        touched.clear();
+        heap.clear();
+        std::greater<std::pair<double, unsigned>> heapOrder;
+        witnessDistance[source] = 0;
+        touched.push_back(source);
+        heap.push_back({0, source});
+        unsigned nSettled = 0;
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), heapOrder);
+            std::pair<double, unsigned> top = heap.back();
+            heap.pop_back();
+            if (top.first > witnessDistance[top.second]) {
+                continue;
+            }
+            if (top.first > maxDistance || ++nSettled > WITNESS_SETTLE_LIMIT) {
+                break;
+            }
+            for (const auto &arc: out[top.second]) {
+                if (contracted[arc.node] || arc.node == skip) continue;
+                double distance = top.first + arc.weight;
+                if (distance < witnessDistance[arc.node]) {
+                    if (witnessDistance[arc.node] == UNREACHED) {
+                        touched.push_back(arc.node);
+                    }
+                    witnessDistance[arc.node] = distance;
+                    heap.push_back({distance, arc.node});
+                    std::push_heap(heap.begin(), heap.end(), heapOrder);
+                }
+            }
+        }
+    }
+
+    /**
+     * This method finds the shortcuts needed to contract a node
+     * @param node This is the node
+     * @param apply This is true to add the shortcuts, otherwise they are only counted
+     * @return The return is the number of shortcuts
+     */
+    unsigned contract(unsigned node, bool apply) {
+        double longestOut = 0;
+        for (const auto &arc: out[node]) {
+            if (!contracted[arc.node]) longestOut = std::max(longestOut, arc.weight);
+        }
+        std::vector<std::pair<std::pair<unsigned, unsigned>, double>> shortcuts;
+        for (const auto &inArc: in[node]) {
+            if (contracted[inArc.node]) continue;
+            witnessSearch(inArc.node, node, inArc.weight + longestOut);
+            for (const auto &outArc: out[node]) {
+                if (contracted[outArc.node] || outArc.node == inArc.node) continue;
+                double through = inArc.weight + outArc.weight;
+                if (witnessDistance[outArc.node] > through) {
+                    shortcuts.push_back({{inArc.node, outArc.node}, through});
+                }
+            }
+        }
+        if (apply) {
+            for (const auto &shortcut: shortcuts) {
+                addArc(shortcut.first.first, shortcut.first.second, shortcut.second, node);
+            }
+        }
+        return shortcuts.size();
+    }
+
+    /**
+     * This method calculates how good it is to contract a node now, the nodes that add less shortcuts than the edges
+     * they remove and whose neighbours were not contracted yet go first (so the contraction is spread over the graph)
+     * @param node This is the node
+     * @return The return is the priority, the lowest goes first
+     */
+    long priority(unsigned node) {
+        long degree = 0;
+        for (const auto &arc: out[node]) degree += !contracted[arc.node];
+        for (const auto &arc: in[node]) degree += !contracted[arc.node];
+        return (long) contract(node, false) - degree + deletedNeighbours[node];
+    }
+};
+
+/**
+ * Constructor (an empty hierarchy, the searches do not use it)
+ */
+ContractionHierarchy::ContractionHierarchy() : nShortcuts(0), walkingDistance(0), services(0) {}
+
+/**
+ * Constructor, it contracts the graph: the node with the lowest priority is contracted next (its priority is
+ * recalculated first, if it got worse it goes back to the queue)
+ * @param nNodes This is the number of nodes of the graph
+ * @param edges This is the list of edges of the graph (the line of an edge is ignored)
+ * @param walkingDistance This is the walking distance the edges were chosen with
+ * @param services This is the bitmask of the service periods the edges were chosen with
+ */
+ContractionHierarchy::ContractionHierarchy(unsigned nNodes, const std::vector<Adjacency::Edge> &edges,
+                                           double walkingDistance, unsigned char services)
+        : rank(nNodes, 0), nShortcuts(0), walkingDistance(walkingDistance), services(services) {
+    ContractionGraph graph(nNodes);
+    for (const auto &edge: edges) {
+        graph.addArc(edge.from, edge.to, edge.weight, NO_NODE);
+    }
+
+    std::greater<std::pair<long, unsigned>> queueOrder;
+    std::vector<std::pair<long, unsigned>> nodesToContract;
+    for (unsigned node = 0; node < nNodes; ++node) {
+        nodesToContract.push_back({graph.priority(node), node});
+    }
+    std::make_heap(nodesToContract.begin(), nodesToContract.end(), queueOrder);
+
+    std::vector<Adjacency::Edge> upwardEdges, downwardEdges;
+    unsigned order = 0;
+    while (!nodesToContract.empty()) {
+        std::pop_heap(nodesToContract.begin(), nodesToContract.end(), queueOrder);
+        unsigned node = nodesToContract.back().second;
+        nodesToContract.pop_back();
+        long current = graph.priority(node);
+        if (!nodesToContract.empty() && current > nodesToContract.front().first) {
+            nodesToContract.push_back({current, node});
+            std::push_heap(nodesToContract.begin(), nodesToContract.end(), queueOrder);
+            continue;
+        }
+        nShortcuts += graph.contract(node, true);
+
+        //the edges left are the ones to nodes that will be contracted later (a higher rank)
+        for (const auto &arc: graph.out[node]) {
+            if (graph.contracted[arc.node]) continue;
+            upwardEdges.push_back({node, arc.node, arc.weight, arc.middle});
+            graph.deletedNeighbours[arc.node]++;
+        }
+        for (const auto &arc: graph.in[node]) {
+            if (graph.contracted[arc.node]) continue;
+            downwardEdges.push_back({node, arc.node, arc.weight, arc.middle});
+            graph.deletedNeighbours[arc.node]++;
+        }
+        graph.contracted[node] = true;
+        rank[node] = order++;
+    }
+    upward = Adjacency(nNodes, upwardEdges);
+    downward = Adjacency(nNodes, downwardEdges);
+}
+
+/**
+ * This method checks if the hierarchy was built
+ * @return The return is true if there are no nodes in the hierarchy
+ */
+bool ContractionHierarchy::empty() const {
+    return rank.empty();
+}
+
+/**
+ * This method gets the number of nodes of the hierarchy
+ * @return The return is the number of nodes
+ */
+unsigned ContractionHierarchy::getNumberNodes() const {
+    return rank.size();
+}
+
+/**
+ * This method gets the number of shortcuts the contraction added
+ * @return The return is the number of shortcuts
+ */
+unsigned ContractionHierarchy::getNumberShortcuts() const {
+    return nShortcuts;
+}
+
+/**
+ * This method gets the walking distance of the graph that was contracted
+ * @return The return is the walking distance in meters
+ */
+double ContractionHierarchy::getWalkingDistance() const {
+    return walkingDistance;
+}
+
+/**
+ * This method gets the service periods of the graph that was contracted
+ * @return The return is the bitmask of the services
+ */
+unsigned char ContractionHierarchy::getServices() const {
+    return services;
+}
+
+/**
+ * This method writes the hierarchy to a snapshot, so it does not have to be contracted again on the next start
+ * @param snapshot This is the snapshot being written
+ */
+void ContractionHierarchy::save(Snapshot &snapshot) const {
+    snapshot.putArray(rank);
+    upward.save(snapshot);
+    downward.save(snapshot);
+    snapshot.put(nShortcuts);
+    snapshot.put(walkingDistance);
+    snapshot.put(services);
+}
+
+/**
+ * This method reads the hierarchy from a snapshot written by save, it is only replaced if it is complete and the
+ * edges and the nodes the shortcuts skip are inside the hierarchy
+ * @param snapshot This is the mapped snapshot
+ * @return The return is true if the hierarchy was read
+ */
+bool ContractionHierarchy::load(Snapshot &snapshot) {
+    ContractionHierarchy read;
+    if (!snapshot.getArray(read.rank) || !read.upward.load(snapshot) || !read.downward.load(snapshot) ||
+        !snapshot.get(read.nShortcuts) || !snapshot.get(read.walkingDistance) || !snapshot.get(read.services)) {
+        return false;
+    }
+    unsigned nNodes = read.rank.size();
+    if (read.upward.getNumberNodes() != nNodes || read.downward.getNumberNodes() != nNodes) {
+        return false;
+    }
+    for (const Adjacency *edges: {&read.upward, &read.downward}) {
+        for (unsigned middle: edges->getLines()) {
+            if (middle != NO_NODE && middle >= nNodes) {
+                return false;
+            }
+        }
+    }
+    *this = std::move(read);
+    return true;
+}
+
+/**
+ * This method finds the shortest path between a set of sources and a set of targets, every source and target has an
+ * extra distance (the walk from a place that is not a node). Both sides only go up the ranks and a side stops when its
+ * closest node is farther than the best path found
+ * @param sources This is the nodes where the path may start and the distance to get to them
+ * @param targets This is the nodes where the path may end and the distance from them to the destination
+ * @param workspace This is the memory the search works on
+ * @param path This is where the nodes of the path are stored, empty if there is no path
+ * @return The return is the distance of the path in meters, INT32_MAX if there is no path
+ */
+double ContractionHierarchy::route(const std::vector<std::pair<unsigned, double>> &sources,
+                                   const std::vector<std::pair<unsigned, double>> &targets,
+                                   SearchWorkspace &workspace, std::vector<unsigned> &path) const {
+    path.clear();
+    workspace.prepare(rank.size());
+    std::greater<std::pair<double, unsigned>> heapOrder;
+    auto start = [&](const std::vector<std::pair<unsigned, double>> &nodes, std::vector<double> &distance,
+                     std::vector<std::pair<double, unsigned>> &nodesToVisit) {
+        for (const auto &node: nodes) {
+            workspace.touch(node.first);
+            if (node.second < distance[node.first]) {
+                distance[node.first] = node.second;
+                nodesToVisit.push_back({node.second, node.first});
+            }
+        }
+        std::make_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+    };
+    start(sources, workspace.bestDistance, workspace.heap);
+    start(targets, workspace.backwardDistance, workspace.backwardHeap);
+
+    double best = UNREACHED;
+    unsigned meeting = NO_NODE;
+    while (!workspace.heap.empty() || !workspace.backwardHeap.empty()) {
+        bool backward = workspace.heap.empty() ||
+                        (!workspace.backwardHeap.empty() && workspace.backwardHeap.front().first < workspace.heap.front().first);
+        std::vector<std::pair<double, unsigned>> &nodesToVisit = backward ? workspace.backwardHeap : workspace.heap;
+        std::vector<double> &distance = backward ? workspace.backwardDistance : workspace.bestDistance;
+        std::vector<unsigned> &previous = backward ? workspace.backwardPrevious : workspace.previous;
+        const std::vector<double> &otherDistance = backward ? workspace.bestDistance : workspace.backwardDistance;
+        const Adjacency &edges = backward ? downward : upward;
+
+        std::pop_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+        std::pair<double, unsigned> top = nodesToVisit.back();
+        nodesToVisit.pop_back();
+        unsigned node = top.second;
+        if (top.first > distance[node]) {
+            continue;
+        }
+        //nothing this side has left can make a better path
+        if (top.first >= best) {
+            nodesToVisit.clear();
+            continue;
+        }
+        if (distance[node] + otherDistance[node] < best) {
+            best = distance[node] + otherDistance[node];
+            meeting = node;
+        }
+        const std::vector<unsigned> &offsets = edges.getOffsets();
+        const std::vector<unsigned> &targetNodes = edges.getTargets();
+        const std::vector<double> &weights = edges.getWeights();
+        for (unsigned e = offsets[node]; e < offsets[node + 1]; ++e) {
+            unsigned neighbour = targetNodes[e];
+            workspace.touch(neighbour);
+            if (distance[node] + weights[e] < distance[neighbour]) {
+                distance[neighbour] = distance[node] + weights[e];
+                previous[neighbour] = node;
+                nodesToVisit.push_back({distance[neighbour], neighbour});
+                std::push_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+            }
+        }
+    }
+    if (meeting == NO_NODE) {
+        return UNREACHED;
+    }
+
+    //the nodes of the hierarchy from the source to the meeting node and from there to the target, with the shortcuts
+    //replaced by the nodes they skip
+    std::vector<unsigned> up;
+    for (unsigned node = meeting; node != NO_NODE; node = workspace.previous[node]) {
+        up.push_back(node);
+    }
+    std::reverse(up.begin(), up.end());
+    path.push_back(up[0]);
+    for (unsigned i = 1; i < up.size(); ++i) {
+        unpack(up[i - 1], up[i], path);
+    }
+    for (unsigned node = meeting; workspace.backwardPrevious[node] != NO_NODE; node = workspace.backwardPrevious[node]) {
+        unpack(node, workspace.backwardPrevious[node], path);
+    }
+    return best;
+}
+
+/**
+ * This method adds the nodes of an edge of the hierarchy to a path, a shortcut is replaced by the two edges it was
+ * made of (which may also be shortcuts)
+ * @param from This is the node the edge leaves (it is already in the path)
+ * @param to This is the node the edge reaches
+ * @param path This is the path the nodes after from are added to
+ */
+void ContractionHierarchy::unpack(unsigned from, unsigned to, std::vector<unsigned> &path) const {
+    //the edge is stored at the node with the lower rank
+    bool up = rank[to] > rank[from];
+    const Adjacency &edges = up ? upward : downward;
+    unsigned at = up ? from : to, other = up ? to : from;
+    unsigned middle = NO_NODE;
+    for (unsigned e = edges.getOffsets()[at]; e < edges.getOffsets()[at + 1]; ++e) {
+        if (edges.getTargets()[e] == other) {
+            middle = edges.getLines()[e];
+            break;
+        }
+    }
+    if (middle == NO_NODE) {
+        path.push_back(to);
+        return;
+    }
+    unpack(from, middle, path);
+    unpack(middle, to, path);
+}
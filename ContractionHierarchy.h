@@ -0,0 +1,71 @@
+/**
+ * @file ContractionHierarchy.h
+ * @brief This file contains the implementation of the contraction hierarchy used for fast distance queries and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 28/1/2022
+ */
+
+#ifndef AEDAGRAFOS_CONTRACTIONHIERARCHY_H
+#define AEDAGRAFOS_CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <utility>
+#include "Adjacency.h"
+#include "SearchWorkspace.h"
+
+/**
+ * This is a contraction hierarchy of a weighted directed graph. The nodes are contracted one at a time, from the least
+ * important to the most important: when a node is removed, a shortcut is added between every pair of its neighbours
+ * whose shortest path went through it. Every shortest path then goes up the ranks and comes back down, so a query is
+ * a bidirectional search that only follows edges going to nodes of a higher rank, and visits very few nodes
+ * @param rank This is the position of every node in the order of contraction
+ * @param upward This is the edges u->w of the graph (with the shortcuts) where w has a higher rank than u, the line of
+ * an edge is the node a shortcut skips (NO_NODE on the edges of the graph)
+ * @param downward This is the edges w->u of the graph (with the shortcuts) where w has a higher rank than u, stored at u
+ * so the backward search can go up them
+ * @param nShortcuts This is the number of shortcuts added
+ * @param walkingDistance This is the walking distance of the graph that was contracted
+ * @param services This is the bitmask of the service periods of the lines of the graph that was contracted
+ */
+class ContractionHierarchy {
+public:
+    static const unsigned NO_NODE = 0xFFFFFFFF;
+
+    ContractionHierarchy();
+
+    ContractionHierarchy(unsigned nNodes, const std::vector<Adjacency::Edge> &edges, double walkingDistance,
+                         unsigned char services);
+
+    bool empty() const;
+
+    unsigned getNumberNodes() const;
+
+    unsigned getNumberShortcuts() const;
+
+    double getWalkingDistance() const;
+
+    unsigned char getServices() const;
+
+    void save(Snapshot &snapshot) const;
+
+    bool load(Snapshot &snapshot);
+
+    double route(const std::vector<std::pair<unsigned, double>> &sources,
+                 const std::vector<std::pair<unsigned, double>> &targets,
+                 SearchWorkspace &workspace, std::vector<unsigned> &path) const;
+
+private:
+    std::vector<unsigned> rank;
+    Adjacency upward;
+    Adjacency downward;
+    unsigned nShortcuts;
+    double walkingDistance;
+    unsigned char services;
+
+    void unpack(unsigned from, unsigned to, std::vector<unsigned> &path) const;
+};
+
+
+#endif //AEDAGRAFOS_CONTRACTIONHIERARCHY_H
@@ -46,7 +46,7 @@ double Coordinate::getLon() const {
  * @param cord2 This is the second coordinate used to calculate the distance
  * @return The return is a double with the distance between the two coordinates in meters
  */
-double Coordinate::haversine(Coordinate cord2 ){
+double Coordinate::haversine(const Coordinate& cord2) const {
 
     const double earthRadius = 6371000; //radius of Earth in maters
 
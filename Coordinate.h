@@ -30,7 +30,7 @@ public:
     double getLat() const;
     double getLon() const;
 
-    double haversine(Coordinate cord2);
+    double haversine(const Coordinate& cord2) const;
 
     friend std::ostream &operator<<(std::ostream &os, const Coordinate &coordinate);
 
@@ -0,0 +1,274 @@
+/**
+ * @file CsvReader.cpp
+ * @brief This file contains the implementation of the functions in CsvReader.h (the streaming CSV parser)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <fstream>
+#include <algorithm>
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include "CsvReader.h"
+
+/**
+ * These are the powers of ten that a double holds exactly, a number whose digits make an integer a double holds
+ * exactly and whose exponent is in this range is parsed with a single division or multiplication, which is correctly
+ * rounded
+ */
+static const double EXACT_POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                             1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+static const int MAX_EXACT_EXPONENT = 22;
+
+/**
+ * This is the biggest integer a double holds exactly (2^53)
+ */
+static const uint64_t MAX_EXACT_MANTISSA = 9007199254740992ULL;
+
+/**
+ * This method copies the field to a string
+ * @return The return is the characters of the field
+ */
+std::string CsvReader::Field::toString() const {
+    return std::string(data, size);
+}
+
+/**
+ * This method compares the field with a string without copying it
+ * @param text This is the string
+ * @return The return is true if the field has the same characters
+ */
+bool CsvReader::Field::equals(const std::string &text) const {
+    return text.size() == size && std::memcmp(text.data(), data, size) == 0;
+}
+
+/**
+ * This method parses the field as a decimal number ([-]digits[.digits][e[-]digits]). The usual coordinates take the
+ * fast path: the digits are read as an integer and scaled by an exact power of ten; the others are given to strtod
+ * @param value This is where the number is stored
+ * @return The return is false if the field is not a number (value is not changed)
+ */
+bool CsvReader::Field::toDouble(double &value) const {
+    const char *current = data, *end = data + size;
+    bool negative = false;
+    if (current != end && (*current == '-' || *current == '+')) {
+        negative = *current == '-';
+        ++current;
+    }
+    uint64_t mantissa = 0;
+    int exponent = 0, nDigits = 0, significantDigits = 0;
+    bool exact = true;
+    for (bool fraction = false; current != end; ++current) {
+        if (*current == '.' && !fraction) {
+            fraction = true;
+            continue;
+        }
+        if (*current < '0' || *current > '9') {
+            break;
+        }
+        nDigits++;
+        if (significantDigits > 0 || *current != '0') {
+            significantDigits++;
+        }
+        if (significantDigits > 19) {
+            exact = false; //the mantissa would overflow, strtod handles it
+            continue;
+        }
+        mantissa = mantissa * 10 + (*current - '0');
+        exponent -= fraction;
+    }
+    if (nDigits == 0) {
+        return false;
+    }
+    if (current != end && (*current == 'e' || *current == 'E')) {
+        ++current;
+        bool negativeExponent = false;
+        if (current != end && (*current == '-' || *current == '+')) {
+            negativeExponent = *current == '-';
+            ++current;
+        }
+        int written = 0, nExponentDigits = 0;
+        for (; current != end && *current >= '0' && *current <= '9'; ++current, ++nExponentDigits) {
+            written = std::min(written * 10 + (*current - '0'), 100000);
+        }
+        if (nExponentDigits == 0) {
+            return false;
+        }
+        exponent += negativeExponent ? -written : written;
+    }
+    if (current != end) {
+        return false;
+    }
+
+    if (exact && mantissa <= MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_EXPONENT && exponent <= MAX_EXACT_EXPONENT) {
+        double result = (double) mantissa;
+        result = exponent < 0 ? result / EXACT_POWERS_OF_TEN[-exponent] : result * EXACT_POWERS_OF_TEN[exponent];
+        value = negative ? -result : result;
+        return true;
+    }
+    std::string copy = toString();
+    value = std::strtod(copy.c_str(), nullptr);
+    return true;
+}
+
+/**
+ * This method parses the field as a non negative integer
+ * @param value This is where the number is stored
+ * @return The return is false if the field is not a non negative integer (value is not changed)
+ */
+bool CsvReader::Field::toUnsigned(unsigned long &value) const {
+    if (size == 0 || size > 9) {
+        return false;
+    }
+    unsigned long result = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] < '0' || data[i] > '9') {
+            return false;
+        }
+        result = result * 10 + (data[i] - '0');
+    }
+    value = result;
+    return true;
+}
+
+/**
+ * This method parses the field as a time of the day, H:MM or H:MM:SS (the hours may pass 24 for the times after the
+ * midnight that ends the day of service)
+ * @param seconds This is where the time in seconds after midnight is stored
+ * @return The return is false if the field is not a time (seconds is not changed)
+ */
+bool CsvReader::Field::toTime(unsigned &seconds) const {
+    unsigned parts[3] = {0, 0, 0};
+    unsigned nParts = 0, nDigits = 0;
+    for (size_t i = 0; i <= size; ++i) {
+        if (i == size || data[i] == ':') {
+            //the hours have one or two digits, the minutes and the seconds have two and are under 60
+            if (nDigits == 0 || nDigits > 2 || (nParts > 0 && (nDigits != 2 || parts[nParts] >= 60))) {
+                return false;
+            }
+            if (++nParts == 3 && i != size) {
+                return false;
+            }
+            nDigits = 0;
+            continue;
+        }
+        if (data[i] < '0' || data[i] > '9') {
+            return false;
+        }
+        parts[nParts] = parts[nParts] * 10 + (data[i] - '0');
+        nDigits++;
+    }
+    if (nParts < 2) {
+        return false;
+    }
+    seconds = parts[0] * 3600 + parts[1] * 60 + parts[2];
+    return true;
+}
+
+/**
+ * Constructor (a reader without a file)
+ */
+CsvReader::CsvReader() : position(0), lineNumber(0) {}
+
+/**
+ * This method reads a whole file into memory with a single read, the rows are then taken from it by nextRow
+ * @param path This is the path of the file
+ * @return The return is true if the file was read
+ */
+bool CsvReader::open(const std::string &path) {
+    this->path = path;
+    content.clear();
+    fields.clear();
+    position = 0;
+    lineNumber = 0;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    content.resize((size_t) file.tellg());
+    file.seekg(0);
+    if (!file.read(content.data(), content.size())) {
+        content.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * This method moves to the next row that is not empty and splits it at the commas (a carriage return at the end of a
+ * line is ignored)
+ * @return The return is false if there are no more rows
+ */
+bool CsvReader::nextRow() {
+    fields.clear();
+    while (position < content.size()) {
+        const char *start = content.data() + position;
+        const char *end = content.data() + content.size();
+        const char *lineEnd = static_cast<const char *>(std::memchr(start, '\n', end - start));
+        if (lineEnd == nullptr) {
+            lineEnd = end;
+        }
+        position = lineEnd - content.data() + 1;
+        lineNumber++;
+        const char *rowEnd = lineEnd;
+        if (rowEnd != start && rowEnd[-1] == '\r') {
+            rowEnd--;
+        }
+        if (rowEnd == start) {
+            continue;
+        }
+        const char *fieldStart = start;
+        for (const char *current = start; current != rowEnd; ++current) {
+            if (*current == ',') {
+                fields.push_back({fieldStart, (size_t) (current - fieldStart)});
+                fieldStart = current + 1;
+            }
+        }
+        fields.push_back({fieldStart, (size_t) (rowEnd - fieldStart)});
+        return true;
+    }
+    return false;
+}
+
+/**
+ * This method gets the fields of the current row
+ * @return The return is the fields, in the order they are in the row
+ */
+const std::vector<CsvReader::Field> &CsvReader::getFields() const {
+    return fields;
+}
+
+/**
+ * This method gets the rest of the current row from a field on, commas included (for a last column that may have
+ * commas, like a name)
+ * @param first This is the index of the first field
+ * @return The return is the characters from that field to the end of the row (empty if the row has less fields)
+ */
+CsvReader::Field CsvReader::getRest(unsigned first) const {
+    if (first >= fields.size()) {
+        return {nullptr, 0};
+    }
+    const Field &last = fields.back();
+    return {fields[first].data, (size_t) (last.data + last.size - fields[first].data)};
+}
+
+/**
+ * This method gets the line of the file of the current row
+ * @return The return is the line number (the first line is 1)
+ */
+unsigned long CsvReader::getLineNumber() const {
+    return lineNumber;
+}
+
+/**
+ * This method tells the user about a problem in the current row, with the file and the line it is in (the message is
+ * written at once, so the messages of readers in different threads do not mix)
+ * @param problem This is the description of the problem
+ */
+void CsvReader::report(const std::string &problem) const {
+    std::cout << path + ":" + std::to_string(lineNumber) + ": " + problem + "\n";
+}
@@ -0,0 +1,71 @@
+/**
+ * @file CsvReader.h
+ * @brief This file contains the implementation of the streaming CSV parser used to read the dataset and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#ifndef AEDAGRAFOS_CSVREADER_H
+#define AEDAGRAFOS_CSVREADER_H
+
+#include <vector>
+#include <string>
+
+/**
+ * This is a parser over a whole CSV file read into memory at once. A row is split in place: its fields only point into
+ * the content of the file (nothing is copied or allocated), and the numbers are parsed straight from there
+ * @param path This is the path of the file, used in the messages about malformed rows
+ * @param content This is the content of the file
+ * @param position This is the position in content where the next row starts
+ * @param lineNumber This is the line of the file of the current row (the first line is 1)
+ * @param fields This is the fields of the current row
+ */
+class CsvReader {
+public:
+    /**
+     * This is a field of a row, the characters stay in the content of the reader (it is only valid until the reader
+     * is destroyed or opens another file)
+     * @param data This is the first character of the field
+     * @param size This is the number of characters of the field
+     */
+    struct Field {
+        const char *data;
+        size_t size;
+
+        std::string toString() const;
+
+        bool equals(const std::string &text) const;
+
+        bool toDouble(double &value) const;
+
+        bool toUnsigned(unsigned long &value) const;
+
+        bool toTime(unsigned &seconds) const;
+    };
+
+    CsvReader();
+
+    bool open(const std::string &path);
+
+    bool nextRow();
+
+    const std::vector<Field> &getFields() const;
+
+    Field getRest(unsigned first) const;
+
+    unsigned long getLineNumber() const;
+
+    void report(const std::string &problem) const;
+
+private:
+    std::string path;
+    std::vector<char> content;
+    size_t position;
+    unsigned long lineNumber;
+    std::vector<Field> fields;
+};
+
+
+#endif //AEDAGRAFOS_CSVREADER_H
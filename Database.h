@@ -18,6 +18,40 @@
     */
 class Database {
 public:
+    /**
+     * This is the longest walking distance (in meters) the walking edges are precomputed for at startup, searches up
+     * to it only filter the edges instead of rebuilding them
+     */
+    static constexpr double MAX_WALKING_DISTANCE = 1000;
+
+    /**
+     * These are the landmarks built at startup for the A* search, they make the searches that walk up to
+     * LANDMARK_WALKING_DISTANCE faster (the ones that walk more use only the straight line bound). The table is built
+     * with the lines of every service so it is a bound for the day and the night searches, it is saved next to the
+     * dataset and loaded on the next start if the dataset did not change
+     */
+    static constexpr unsigned NUMBER_LANDMARKS = 8;
+    static constexpr double LANDMARK_WALKING_DISTANCE = 300;
+
+    /**
+     * These are the walking distances the contraction hierarchies of the day and night services are built for at
+     * startup, the searches with that walking distance and no limits use them (a negative one builds no hierarchy)
+     */
+    static constexpr double DAY_HIERARCHY_WALKING_DISTANCE = 300;
+    static constexpr double NIGHT_HIERARCHY_WALKING_DISTANCE = 300;
+
+    /**
+     * This is true if the buses of the graph can only be taken in the direction of travel of their line (the other
+     * direction of a line is read as a separate line)
+     */
+    static constexpr bool DIRECTED_LINES = true;
+
+    /**
+     * This is the snapshot of the built graph written by "AEDAGrafos --compile-snapshot", a start loads it instead of
+     * reading the dataset. It keeps the stamp of the dataset files it was built from, after one of them changes it is
+     * ignored (and has to be compiled again to be used)
+     */
+    static constexpr const char* SNAPSHOT_PATH = "./dataset/network.bin";
 
     Stop partida;
     Stop chegada;
@@ -26,15 +60,61 @@ public:
     int maxlines;
     int maxzones;
     bool dayShift;
-    Graph mapNight;
-    Graph mapDay;
+    unsigned departureTime;
+    Graph map;
     Database() {
+        if (!map.loadSnapshot(SNAPSHOT_PATH, datasetStamp())) {
+            map = readNetwork();
+        }
+        //a snapshot compiled with other settings is completed with what is missing
+        if (map.getWalkLayerDistance() < MAX_WALKING_DISTANCE) {
+            map.precomputeWalkEdges(MAX_WALKING_DISTANCE);
+        }
+        buildHierarchies(map);
+        if (!map.loadLandmarks("./dataset/landmarks_all.bin")) {
+            map.buildLandmarks(NUMBER_LANDMARKS, LANDMARK_WALKING_DISTANCE, Line::ALL_SERVICES);
+            map.saveLandmarks("./dataset/landmarks_all.bin");
+        }
+    };
+
+    /**
+     * This reads the dataset and builds the graph with its walking edges and contraction hierarchies, it is what the
+     * snapshot stores
+     * @return The return is the graph built
+     */
+    static Graph readNetwork() {
         Reader myReader;
         std::set<Stop> myStops =myReader.readStops("./dataset/stops.csv");
         std::set<Line> myLines =myReader.readLines("./dataset/lines.csv", myStops);
-        mapDay = Graph(myStops, myLines, false);
-        mapNight = Graph(myStops, myLines, true);
-    };
+        //the day and the night lines share one graph, a search only takes the lines of its service
+        Graph network(myStops, myLines, DIRECTED_LINES);
+        network.precomputeWalkEdges(MAX_WALKING_DISTANCE);
+        buildHierarchies(network);
+        return network;
+    }
+
+    /**
+     * This gets the stamp of the dataset files as they are now, the snapshot is only loaded if it has the same one
+     * @return The return is the stamp
+     */
+    static uint64_t datasetStamp() {
+        return Reader::datasetStamp("./dataset/stops.csv", "./dataset/lines.csv");
+    }
+
+    /**
+     * This builds the contraction hierarchies of the day and night services that the graph does not have yet
+     * @param network This is the graph
+     */
+    static void buildHierarchies(Graph& network) {
+        if (DAY_HIERARCHY_WALKING_DISTANCE >= 0 &&
+            !network.hasContractionHierarchy(DAY_HIERARCHY_WALKING_DISTANCE, Line::DAY_SERVICE)) {
+            network.buildContractionHierarchy(DAY_HIERARCHY_WALKING_DISTANCE, Line::DAY_SERVICE);
+        }
+        if (NIGHT_HIERARCHY_WALKING_DISTANCE >= 0 &&
+            !network.hasContractionHierarchy(NIGHT_HIERARCHY_WALKING_DISTANCE, Line::NIGHT_SERVICE)) {
+            network.buildContractionHierarchy(NIGHT_HIERARCHY_WALKING_DISTANCE, Line::NIGHT_SERVICE);
+        }
+    }
 };
 
 
@@ -7,176 +7,1630 @@
  * @date 22/1/2022
  */
 
+#include <cmath>
+#include <thread>
+#include <atomic>
 #include "Graph.h"
 
+const unsigned Graph::NO_STOP;
+
+/**
+ * This is the side (in meters) of the cells of the spatial index over the stops, close to the usual walking distances
+ */
+static const double STOP_GRID_CELL_SIZE = 250;
+
+/**
+ * The A* search estimates the distance left with a flat projection, it is divided by this so the estimate is never
+ * longer than the real distance (the projection is exact up to a tiny curvature error)
+ */
+static const double A_STAR_SLACK = 1.001;
+
+/**
+ * These are the settings of the alternative routes: an edge between two stops of the paths found before gets
+ * ALTERNATIVE_PENALTY of its length longer for every path that has both, a path is only an alternative if it is at most
+ * ALTERNATIVE_STRETCH times as long as the shortest one and shares at most ALTERNATIVE_OVERLAP of its length with every
+ * alternative found before, and ALTERNATIVE_SEARCHES searches at most are made for every route asked
+ */
+static const double ALTERNATIVE_PENALTY = 0.5;
+static const double ALTERNATIVE_STRETCH = 1.5;
+static const double ALTERNATIVE_OVERLAP = 0.7;
+static const unsigned ALTERNATIVE_SEARCHES = 2;
+
+/**
+ * This is the number of stops a thread takes at once when the walking edges are built, the edges of every group of
+ * stops are kept apart and joined in the order of the stops at the end
+ */
+static const unsigned WALK_EDGES_CHUNK = 128;
+
+/**
+ * This is the fewest bytes a stop takes in a snapshot (its code, name and zone empty), the number of stops of a
+ * snapshot can not be more than the bytes left divided by it
+ */
+static const size_t SNAPSHOT_STOP_SIZE = 3 * sizeof(uint32_t) + 2 * sizeof(double) + sizeof(unsigned);
+
 /**
  * Constructor
- * @param num This is the number of stops of the graph
- * @param dir This is true if the graph is directional, otherwise it is false
+ * @param myStops This is the stops of the graph
+ * @param myLines This is the lines of the graph, of every service period (the edges of a line keep its services so a
+ * search only takes the lines of the services it asks for)
+ * @param directed This is true if a bus can only be taken in the direction of travel of its line, otherwise every line
+ * edge also goes back (the two directions of a line are separate lines, so a directed graph has half the edges)
+ * @param nThreads This is the number of threads that make the edges of the lines, 0 uses one for every core (the edges
+ * of every line are made apart and joined in the order of the lines, so the graph does not depend on it)
  */
-Graph::Graph(std::set<Stop> myStops, std::set<Line> myLines, bool isNight): walkingDistance(0){
+Graph::Graph(std::set<Stop> myStops, std::set<Line> myLines, bool directed, unsigned nThreads): directed(directed), services(Line::ALL_SERVICES), walkingDistance(0), walkLayerDistance(0){
     for (auto stop:myStops) {
         stops.push_back(stop);
     }
-    double distance;
+    indexStops();
+    lineCodes.push_back("walk");
 
-    std::string lastStop;
-    for (auto line: myLines) {
-        lastStop = "";
-        for(auto stop:line.getStops()) {
-            if (line.getCode().at(line.getCode().size()-1) != 'M' && isNight){
-                continue;
-            }
-            else if(line.getCode().at(line.getCode().size()-1) == 'M' && !isNight){
-                continue;
-            }
-            if (!lastStop.empty()){
-                Stop& origin= *std::find(stops.begin(), stops.end(), stop);
-                Stop& destiny = *std::find(stops.begin(), stops.end(), lastStop);
-                distance = origin.distance(destiny);
-                origin.addLineNeighbour({distance, destiny, line.getCode()});
-                destiny.addLineNeighbour({distance, origin, line.getCode()});
+    std::vector<std::vector<unsigned>> routes;
+    std::vector<unsigned char> routeServices;
+    std::vector<std::vector<std::vector<unsigned>>> routeTrips;
+    for (const auto& line: myLines) {
+        if (line.getCode().empty()) {
+            continue; //a line whose file could not be read
+        }
+        lineCodes.push_back(line.getCode());
+        routes.emplace_back();
+        routeServices.push_back(line.getServices());
+        routeTrips.push_back(line.getTrips());
+        for(const auto& stop:line.getStops()) {
+            routes.back().push_back(stopIndex.at(stop));
+        }
+    }
+
+    //the route r is the line r + 1, every thread takes the next route that no one took yet
+    std::vector<std::vector<Adjacency::Edge>> routeEdges(routes.size());
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<size_t>(nThreads, std::max<size_t>(1, routes.size()));
+    std::atomic<size_t> nextRoute(0);
+    auto worker = [&]() {
+        for (size_t r = nextRoute++; r < routes.size(); r = nextRoute++) {
+            unsigned lineId = r + 1;
+            for (unsigned i = 1; i < routes[r].size(); ++i) {
+                unsigned lastStop = routes[r][i - 1], current = routes[r][i];
+                double distance = stops[current].distance(stops[lastStop]);
+                routeEdges[r].push_back({lastStop, current, distance, lineId, routeServices[r]});
+                if (!directed) {
+                    routeEdges[r].push_back({current, lastStop, distance, lineId, routeServices[r]});
+                }
             }
-            lastStop = stop;
         }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < nThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
     }
+
+    std::vector<Adjacency::Edge> edges;
+    for (const auto& buffer: routeEdges) {
+        edges.insert(edges.end(), buffer.begin(), buffer.end());
+    }
+    lineEdges = Adjacency(stops.size(), edges);
+    reverseLineEdges = lineEdges.reversed();
+    walkEdges = Adjacency(stops.size(), {});
+    timetable = Timetable(routes, routeServices, routeTrips);
+    //the buses of a graph that is not directed go both ways, so the way back of every line is a route too
+    if (!directed) {
+        size_t nForward = routes.size();
+        for (size_t r = 0; r < nForward; ++r) {
+            routes.emplace_back(routes[r].rbegin(), routes[r].rend());
+            routeServices.push_back(routeServices[r]);
+        }
+    }
+    raptor = Raptor(stops, routes, routeServices);
 }
 
 /**
- * This method connects (mark as edges) the Stops (nodes) that closer than a set distance
+ * This method connects (mark as edges) the Stops (nodes) that closer than a set distance, the walking edges are only
+ * rebuilt if the distance is bigger than the one they were precomputed for, otherwise the searches just ignore the
+ * edges that are too long (rebuilding them empties the route cache, the paths of a smaller distance stay valid)
  * @param walkingDistance This is the distance in meter to connect the edges as walking edges
  */
 void Graph::connectWalkStop(double walkingDistance) {
     this->walkingDistance = walkingDistance;
-    clearWalkNeighbours();
-    double distance;
-    for (auto &node: stops) {
-        for (auto &maybeNeighbour: stops) {
-            distance = node.distance(maybeNeighbour);
-            if(distance<=walkingDistance && node.getCode() != maybeNeighbour.getCode()){
-                node.addWalkNeighbour({distance, maybeNeighbour, "walk"});
+    if (walkingDistance > walkLayerDistance) {
+        precomputeWalkEdges(walkingDistance);
+    }
+}
+
+/**
+ * This method builds the walking edges between all the stops up to a maximum distance, the edges of every stop are
+ * sorted from the shortest to the longest so a search with a smaller walking distance only uses the first ones. The
+ * stops are split in groups shared by a pool of threads, the edges of every group are joined in the order of the stops
+ * so the result does not depend on the number of threads
+ * @param maxWalkingDistance This is the longest distance in meters that a walking edge can have
+ * @param nThreads This is the number of threads, 0 uses one for every core
+ */
+void Graph::precomputeWalkEdges(double maxWalkingDistance, unsigned nThreads) {
+    walkLayerDistance = maxWalkingDistance;
+    routeCache.clear();
+    auto shorter = [](const std::pair<unsigned, double>& a, const std::pair<unsigned, double>& b) {
+        return a.second < b.second || (a.second == b.second && a.first < b.first);
+    };
+    size_t nChunks = (stops.size() + WALK_EDGES_CHUNK - 1) / WALK_EDGES_CHUNK;
+    std::vector<std::vector<Adjacency::Edge>> chunkEdges(nChunks);
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<size_t>(nThreads, std::max<size_t>(1, nChunks));
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        std::vector<std::pair<unsigned, double>> neighbours;
+        for (size_t chunk = nextChunk++; chunk < nChunks; chunk = nextChunk++) {
+            unsigned end = std::min<size_t>(stops.size(), (chunk + 1) * WALK_EDGES_CHUNK);
+            for (unsigned node = chunk * WALK_EDGES_CHUNK; node < end; ++node) {
+                stopGrid.withinRadius(stops[node].getCoordinate(), maxWalkingDistance, neighbours);
+                std::sort(neighbours.begin(), neighbours.end(), shorter);
+                for (const auto& neighbour: neighbours) {
+                    if (neighbour.first != node) {
+                        chunkEdges[chunk].push_back({node, neighbour.first, neighbour.second, 0});
+                    }
+                }
             }
         }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < nThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    std::vector<Adjacency::Edge> edges;
+    for (const auto& buffer: chunkEdges) {
+        edges.insert(edges.end(), buffer.begin(), buffer.end());
+    }
+    walkEdges = Adjacency(stops.size(), edges);
+}
+
+/**
+ * This method finds the nodes where a search starts and ends, the stops that are not in the graph are linked by walking
+ * to the stops close to them without changing the graph
+ * @param start This is the place where the search starts
+ * @param dest This is the place the search is trying to get to
+ * @param walkingDistance This is the maximum distance to walk between a place that is not a stop and a stop
+ * @param services This is the bitmask of the service periods of the lines the search can take
+ * @return The return is the endpoints of the search
+ */
+Graph::Endpoints Graph::findEndpoints(const Stop &start, const Stop &dest, double walkingDistance, unsigned char services) const {
+    Endpoints endpoints;
+    endpoints.services = services;
+    endpoints.source = getStopIndex(start.getCode());
+    endpoints.target = getStopIndex(dest.getCode());
+
+    if (endpoints.source == NO_STOP) {
+        endpoints.source = stops.size();
+        endpoints.sourceLinks = stopsWithinRadius(start.getCoordinate(), walkingDistance);
+        std::sort(endpoints.sourceLinks.begin(), endpoints.sourceLinks.end());
+    }
+    if (endpoints.target == NO_STOP) {
+        endpoints.target = stops.size() + 1;
+        endpoints.targetLinks = stopsWithinRadius(dest.getCoordinate(), walkingDistance);
+        std::sort(endpoints.targetLinks.begin(), endpoints.targetLinks.end());
+        //two places that are not stops can also be close enough to just walk
+        double direct = start.distance(dest);
+        if (endpoints.source == stops.size() && direct <= walkingDistance) {
+            endpoints.sourceLinks.emplace_back(endpoints.target, direct);
+        }
     }
+    return endpoints;
+}
+
+/**
+ * This method calls a function for every edge leaving a node during a search: the walking edges up to the walking
+ * distance, the line edges of the services of the search and the walking links of the virtual endpoints. The backward side of a search follows the
+ * edges that reach the node instead (the walking edges go both ways, the line edges are turned around) and the links of
+ * the endpoints are swapped
+ * @param node This is the node being expanded
+ * @param endpoints This is the endpoints of the search
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @param backward This is true if the search goes from the destination to the start
+ * @param visit This is the function called with the neighbour, the distance in meters and the interned line of every edge
+ */
+template<typename Visit>
+void Graph::forEachNeighbour(unsigned node, const Endpoints &endpoints, double walkingDistance, bool backward, Visit visit) const {
+    if (node >= stops.size()) {
+        //a virtual endpoint only has the walking links to the stops around it, and only its own side expands it
+        if (node == (backward ? endpoints.target : endpoints.source)) {
+            for (const auto& link: backward ? endpoints.targetLinks : endpoints.sourceLinks) {
+                visit(link.first, link.second, 0);
+            }
+        }
+        return;
+    }
+    const std::vector<unsigned>& walkOffsets = walkEdges.getOffsets();
+    const std::vector<unsigned>& walkTargets = walkEdges.getTargets();
+    const std::vector<double>& walkWeights = walkEdges.getWeights();
+    const Adjacency& lines = backward ? reverseLineEdges : lineEdges;
+    const std::vector<unsigned>& lineOffsets = lines.getOffsets();
+    const std::vector<unsigned>& lineTargets = lines.getTargets();
+    const std::vector<double>& lineWeights = lines.getWeights();
+    const std::vector<unsigned>& lineIds = lines.getLines();
+    const std::vector<unsigned char>& lineServices = lines.getServices();
+
+    //the walking edges are sorted by distance, only the ones up to the walking distance are used
+    for (unsigned e = walkOffsets[node]; e < walkOffsets[node + 1] && walkWeights[e] <= walkingDistance; ++e) {
+        visit(walkTargets[e], walkWeights[e], 0);
+    }
+    for (unsigned e = lineOffsets[node]; e < lineOffsets[node + 1]; ++e) {
+        if (lineServices[e] & endpoints.services) {
+            visit(lineTargets[e], lineWeights[e], lineIds[e]);
+        }
+    }
+    //the links of the other endpoint are sorted by the stop
+    const auto& links = backward ? endpoints.sourceLinks : endpoints.targetLinks;
+    auto link = std::lower_bound(links.begin(), links.end(), std::make_pair(node, 0.0));
+    if (link != links.end() && link->first == node) {
+        visit(backward ? endpoints.source : endpoints.target, link->second, 0);
+    }
+}
+
+/**
+ * This method checks if a label is at least as good as another one at the same stop for every criteria, so the other
+ * one can be discarded
+ * @param a This is the label that may be better
+ * @param b This is the label that may be discarded
+ * @return The return is true if a path that continues b can never be better than the same path continuing a
+ */
+bool Graph::dominates(const SearchWorkspace::Label &a, const SearchWorkspace::Label &b) {
+    if (a.distance > b.distance || (a.zones & ~b.zones).any()) {
+        return false;
+    }
+    //the one that is on the same bus as b can keep going with it, the other one may need to take it
+    return a.line == b.line ? a.boardings <= b.boardings : a.boardings + 1 <= b.boardings;
 }
 
 /**
  * This method gets the closer distance in meters between to stops (places) that also have a max number of zones and
- * a max number of line changes (bus changes)
- * @param startCode This is the place (stop) where the graph will start searching
- * @param destCode This is the destination place, where we are trying to get to
+ * a max number of line changes (bus changes). It is a label-setting search: a stop may keep more than one label
+ * (distance, buses taken and zones passed) as long as no label is better than the other in every criteria, so a path
+ * that is longer but changes less lines is not lost
+ * @param startCode This is the place (stop or coordinate) where the graph will start searching
+ * @param destCode This is the destination place (stop or coordinate), where we are trying to get to
+ * @param nLinesToChange This is the maximum number of lines change allowed
+ * @param nZones This is the maximum number of zones allowed
+ * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::dijkstra(const Stop& start, const Stop& dest, const int nLinesToChange, const int nZones) const {
+    SearchWorkspace workspace;
+    return dijkstra(start, dest, nLinesToChange, nZones, walkingDistance, services, workspace);
+}
+
+/**
+ * This method is the dijkstra search working on a workspace given by the caller (it can be reused between searches)
+ * @param startCode This is the place (stop or coordinate) where the graph will start searching
+ * @param destCode This is the destination place (stop or coordinate), where we are trying to get to
  * @param nLinesToChange This is the maximum number of lines change allowed
  * @param nZones This is the maximum number of zones allowed
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
  * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
  */
-std::list<Stop> Graph::dijkstra(const Stop& start, const Stop& dest, const int nLinesToChange = INT32_MAX, const int nZones = INT32_MAX) {
+std::list<Stop> Graph::dijkstra(const Stop& start, const Stop& dest, const int nLinesToChange, const int nZones,
+                                double walkingDistance, unsigned char services, SearchWorkspace& workspace) const {
 
-    std::vector<DistancePath> visitedStopsInfo; //visitedStopsInfo vector
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    unsigned nNodes = stops.size() + 2; //the stops and the two virtual endpoints
+    workspace.prepare(nNodes);
 
-    std::priority_queue<std::tuple<double, Stop, std::string>, std::vector<std::tuple<double, Stop, std::string>>, std::greater<>> stopsToVisit;
+    //a criteria that can never go over its limit is not tracked, without any the search is a plain dijkstra
+    bool trackLines = nLinesToChange != INT32_MAX;
+    bool trackZones = nZones < (int) nZoneIds;
+    long maxBoardings = (long) nLinesToChange + 1;
+    auto zoneOf = [&](unsigned node) {
+        std::bitset<Stop::MAX_ZONES> zone;
+        if (node < stops.size() && stopZones[node] != Stop::NO_ZONE) {
+            zone.set(std::min(stopZones[node], Stop::MAX_ZONES - 1));
+        }
+        return zone;
+    };
 
-    //initialize the dist & visited vectors
-    for (const auto& stop: stops) {
-        visitedStopsInfo.emplace_back(stop.getCode(), INT32_MAX, "walk");
-    }
-
-    std::find(visitedStopsInfo.begin(), visitedStopsInfo.end(), start.getCode())->setForInit();
-    stopsToVisit.push({0, *std::find(stops.begin(), stops.end(), start.getCode()), "walk"});
-
-    while (!stopsToVisit.empty()) {
-        std::tuple<double, Stop, std::string> currentStopQueueInfo = stopsToVisit.top(); //get top currentStop
-        Stop currentStop = std::get<1>(currentStopQueueInfo); //get the node of iteratorNeighbours
-        stopsToVisit.pop(); //remove from queue
-        std::string currentStopLineCode = std::get<2>(currentStopQueueInfo);
-        DistancePath &currentStopPathInfo = *std::find(visitedStopsInfo.begin(), visitedStopsInfo.end(), currentStop.getCode());
-        std::vector<std::string> currentStopLines = currentStopPathInfo.getLinesChanged();
-        if(currentStopLines.empty() || currentStopLines.back() != std::get<2>(currentStopQueueInfo)){
-            currentStopLines.push_back(std::get<2>(currentStopQueueInfo));
-        }
-        std::string neighbourLineCode;
-        currentStopPathInfo.visited();
-        currentStopPathInfo.getZones().insert(currentStop.getZone());
-        std::set<std::string> neighbourZones = currentStopPathInfo.getZones();
-        neighbourZones.insert(currentStop.getZone());
-
-        for (auto neighbour: combineAllNeighbours(currentStop.getLineNeighbours(),
-                                                  currentStop.getWalkNeighbours()) ) {
-
-            //get neighbour and dist from iteratorNeighbours
-            double distCurrentToNeighbour = std::get<0>(neighbour);
-            Stop &neighbourStop = std::get<1>(neighbour);
-            DistancePath &neighbourPath = *std::find(visitedStopsInfo.begin(), visitedStopsInfo.end(),
-                                                     neighbourStop.getCode());
-            //absolute min visitedStopsInfo
-            neighbourLineCode = std::get<2>(neighbour);
-
-            if (!neighbourPath.isVisited() &&
-                (currentStopPathInfo.getDistance() + distCurrentToNeighbour) < neighbourPath.getDistance() &&
-                currentStopLines.size() <= nLinesToChange && neighbourZones.size() < nZones) {
-
-                neighbourPath.setDistance(currentStopPathInfo.getDistance() + distCurrentToNeighbour);
-                neighbourPath.setPrevious(currentStop.getCode());
-                stopsToVisit.push({neighbourPath.getDistance(), neighbourStop, neighbourLineCode});
-                neighbourPath.setLinesChanged(currentStopLines);
-                neighbourPath.setZones(neighbourZones);
+    std::vector<SearchWorkspace::Label>& labels = workspace.labels;
+    std::vector<std::vector<unsigned>>& settled = workspace.settled;
+    std::vector<double>& bestDistance = workspace.bestDistance; //only used when no criteria is tracked
+
+    //in pair, first the distance and after the index of the label, kept as a heap with the smallest on top
+    std::vector<std::pair<double, unsigned>>& labelsToVisit = workspace.heap;
+    std::greater<std::pair<double, unsigned>> heapOrder;
+
+    workspace.touch(endpoints.source);
+    labels.push_back({0, endpoints.source, 0, 0, trackZones ? zoneOf(endpoints.source) : std::bitset<Stop::MAX_ZONES>(), NO_STOP});
+    labelsToVisit.push_back({0, 0});
+    unsigned found = NO_STOP;
+
+    while (!labelsToVisit.empty()) {
+        std::pop_heap(labelsToVisit.begin(), labelsToVisit.end(), heapOrder);
+        unsigned current = labelsToVisit.back().second;
+        labelsToVisit.pop_back();
+        const SearchWorkspace::Label label = labels[current]; //copied, new labels may move the vector
+        bool dominated = false;
+        for (unsigned other: settled[label.node]) {
+            if (dominates(labels[other], label)) {
+                dominated = true;
+                break;
             }
         }
+        if (dominated) {
+            continue;
+        }
+        settled[label.node].push_back(current);
+        //labels leave the queue by distance, the first one at the destination is the shortest path that is allowed
+        if (label.node == endpoints.target) {
+            found = current;
+            break;
+        }
+
+        auto extend = [&](unsigned neighbour, double weight, unsigned line) {
+            workspace.touch(neighbour);
+            SearchWorkspace::Label next = {label.distance + weight, neighbour, 0, 0, {}, current};
+            if (trackLines) {
+                next.line = line;
+                next.boardings = label.boardings + (line != 0 && line != label.line ? 1 : 0);
+                if (next.boardings > maxBoardings) return;
+            }
+            if (trackZones) {
+                next.zones = label.zones | zoneOf(neighbour);
+                if (next.zones.count() > (unsigned) nZones) return;
+            }
+            if (!trackLines && !trackZones) {
+                if (next.distance >= bestDistance[neighbour]) return;
+                bestDistance[neighbour] = next.distance;
+            }
+            for (unsigned other: settled[neighbour]) {
+                if (dominates(labels[other], next)) return;
+            }
+            labels.push_back(next);
+            labelsToVisit.push_back({next.distance, (unsigned) labels.size() - 1});
+            std::push_heap(labelsToVisit.begin(), labelsToVisit.end(), heapOrder);
+        };
+        forEachNeighbour(label.node, endpoints, walkingDistance, false, extend);
     }
 
-    return currentPath(visitedStopsInfo, start, dest);
+    //rebuild the path by following the labels back to the start
+    std::list<Stop> path;
+    for (unsigned current = found; current != NO_STOP; current = labels[current].parent) {
+        unsigned node = labels[current].node;
+        path.push_front(node < stops.size() ? stops[node] : (node == endpoints.source ? start : dest));
+    }
+    return path;
 }
 
 /**
  * This method calculates the path with the least number of stops between two stops (node) in the graph
- * @param startCode This is the place (stop) where the graph will start searching
- * @param destCode This is the destination place, where we are trying to get to
+ * @param startCode This is the place (stop or coordinate) where the graph will start searching
+ * @param destCode This is the destination place (stop or coordinate), where we are trying to get to
  * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
  */
-std::list<Stop> Graph::BFS(const Stop& start, const Stop& dest) {
+std::list<Stop> Graph::BFS(const Stop& start, const Stop& dest) const {
+    SearchWorkspace workspace;
+    return BFS(start, dest, walkingDistance, services, workspace);
+}
 
-    std::vector<DistancePath> visitedStopsInfo; //distance vector
+/**
+ * This method is the BFS search working on a workspace given by the caller (it can be reused between searches)
+ * @param startCode This is the place (stop or coordinate) where the graph will start searching
+ * @param destCode This is the destination place (stop or coordinate), where we are trying to get to
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::BFS(const Stop& start, const Stop& dest, double walkingDistance, unsigned char services,
+                           SearchWorkspace& workspace) const {
 
-    //queue for stops to visit
-    std::queue<Stop> stopsToVisit;
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    unsigned nNodes = stops.size() + 2; //the stops and the two virtual endpoints
+    workspace.prepare(nNodes);
 
-    //initialize the dist & visited vectors
-    for (const auto& stop: stops) {
-        visitedStopsInfo.emplace_back(stop.getCode(), INT32_MAX, "walk");
+    //search state, indexed by the position of the stop
+    std::vector<unsigned>& previous = workspace.previous;
+    std::vector<char>& visited = workspace.visited;
+
+    //queue for the indexes of the stops to visit, the ones before head were already visited
+    std::vector<unsigned>& stopsToVisit = workspace.fifo;
+    size_t head = 0;
+
+    workspace.touch(endpoints.source);
+    workspace.touch(endpoints.target);
+    visited[endpoints.source] = true;
+    stopsToVisit.push_back(endpoints.source);
+
+    //the path to a stop never changes after it is visited, so the search stops when the destination is visited
+    while (head < stopsToVisit.size() && !visited[endpoints.target]) {
+        unsigned currentIndex = stopsToVisit[head++];
+
+        //iterate walk and line neighbours, if the neighbour was not visited, visit it
+        forEachNeighbour(currentIndex, endpoints, walkingDistance, false, [&](unsigned neighbour, double, unsigned) {
+            workspace.touch(neighbour);
+            if(!visited[neighbour]){
+                visited[neighbour] = true;
+                previous[neighbour] = currentIndex;
+                stopsToVisit.push_back(neighbour);
+            }
+        });
+    }
+
+    //rebuild the path by following the predecessors back to the start
+    std::list<Stop> path;
+    if (visited[endpoints.target]) {
+        for (unsigned current = endpoints.target; current != NO_STOP; current = previous[current]) {
+            path.push_front(current < stops.size() ? stops[current] : (current == endpoints.source ? start : dest));
+        }
+    }
+    return path;
+}
+
+/**
+ * This method gets the shortest distance between two places with an A* search, using the walking distance the graph
+ * was connected with
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @return It returns a list of stops (the shortest path), if there is no path it return an empty list
+ */
+std::list<Stop> Graph::aStar(const Stop &start, const Stop &dest) const {
+    SearchWorkspace workspace;
+    return aStar(start, dest, walkingDistance, services, workspace);
+}
+
+/**
+ * This method gets the shortest distance between two places with an A* search: the nodes are expanded by their
+ * distance from the start plus a lower bound of the distance left to the destination, so the search goes towards the
+ * destination instead of in every direction. Every edge is at least as long as the straight line between its stops, so
+ * the straight line distance to the destination is a bound that never overestimates; it is measured on a flat
+ * projection (cheaper than the haversine) whose degree of longitude is the shortest one of the places involved.
+ * When the graph has landmarks built for at least the walking distance of the search, the bound is also the best of
+ * the triangle inequality bounds of the landmarks (ALT), which are usually a lot closer to the real distance
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (the shortest path), if there is no path it return an empty list
+ */
+std::list<Stop> Graph::aStar(const Stop &start, const Stop &dest, double walkingDistance, unsigned char services,
+                             SearchWorkspace &workspace) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    std::vector<unsigned> nodes = aStarNodes(endpoints, start, dest, walkingDistance, INT32_MAX, workspace,
+                                             [](unsigned, unsigned) { return 1.0; });
+    std::list<Stop> path;
+    for (unsigned node: nodes) {
+        path.push_back(node < stops.size() ? stops[node] : (node == endpoints.source ? start : dest));
     }
+    return path;
+}
 
-    std::find(visitedStopsInfo.begin(), visitedStopsInfo.end(), start.getCode())->visited();
-    std::string currentCode = start.getCode();
+/**
+ * This method is the A* search used by aStar and by alternativeRoutes, the length of every edge can be multiplied by a
+ * penalty (at least 1, so the bounds of the A* search are still lower bounds)
+ * @param endpoints This is the endpoints of the search
+ * @param start This is the place where the search starts
+ * @param dest This is the place the search is trying to get to
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @param limit This is the longest path (with the penalties) the search looks for, the nodes that can only be reached
+ * by longer paths are not expanded
+ * @param workspace This is the memory the search works on (the distance of every node is the one with the penalties)
+ * @param penalty This is the function that gets the penalty of the edges between two nodes
+ * @return It returns the nodes of the shortest path with the penalties, from the source to the target, or an empty
+ * vector if there is no path shorter than the limit
+ */
+template<typename Penalty>
+std::vector<unsigned> Graph::aStarNodes(const Endpoints &endpoints, const Stop &start, const Stop &dest,
+                                        double walkingDistance, double limit, SearchWorkspace &workspace,
+                                        Penalty penalty) const {
+    workspace.prepare(stops.size() + 2); //the stops and the two virtual endpoints
 
-    do{
-        const Stop& currentStop = *std::find(stops.begin(), stops.end(), currentCode);
+    //the distances between every landmark and the destination, the virtual destination is reached from the stops linked
+    //to it: for every landmark, the index, the distance from it to the destination and the longest distance from a
+    //linked stop to it minus the link (-INT32_MAX when there is none of them, or when a linked stop can not reach the
+    //landmark: a path through that stop is then not bounded by it)
+    const unsigned nLandmarks = landmarks.getNumberLandmarks();
+    const std::vector<double>& distancesFrom = landmarks.getDistancesFrom();
+    const std::vector<double>& distancesTo = landmarks.getDistancesTo();
+    std::vector<std::tuple<unsigned, double, double>> targetRanges;
+    if (!landmarks.empty() && std::min(walkingDistance, walkLayerDistance) <= landmarks.getWalkingDistance() &&
+        (services & ~landmarks.getServices()) == 0) {
+        for (unsigned k = 0; k < nLandmarks; ++k) {
+            double lowest = INT32_MAX, highest = -INT32_MAX;
+            bool unreachable = false;
+            auto addLink = [&](unsigned stop, double link) {
+                if (distancesFrom[stop * nLandmarks + k] < INT32_MAX) {
+                    lowest = std::min(lowest, distancesFrom[stop * nLandmarks + k] + link);
+                }
+                if (distancesTo[stop * nLandmarks + k] < INT32_MAX) {
+                    highest = std::max(highest, distancesTo[stop * nLandmarks + k] - link);
+                } else {
+                    unreachable = true;
+                }
+            };
+            if (endpoints.target < stops.size()) {
+                addLink(endpoints.target, 0);
+            }
+            for (const auto& link: endpoints.targetLinks) {
+                addLink(link.first, link.second);
+            }
+            if (unreachable) {
+                highest = -INT32_MAX;
+            }
+            if (lowest < INT32_MAX || highest > -INT32_MAX) {
+                targetRanges.emplace_back(k, lowest, highest);
+            }
+        }
+    }
+
+    const Coordinate& goal = dest.getCoordinate();
+    const double metersPerDegreeLat = stopGrid.getMetersPerDegreeLat();
+    double farthestCos = std::min(std::cos(start.getCoordinate().getLat() * M_PI / 180.0),
+                                  std::cos(goal.getLat() * M_PI / 180.0));
+    double metersPerDegreeLon = std::min(stopGrid.getMetersPerDegreeLon(), metersPerDegreeLat * farthestCos);
+    auto bound = [&](unsigned node) {
+        if (node == endpoints.target) {
+            return 0.0;
+        }
+        const Coordinate& place = node < stops.size() ? stops[node].getCoordinate() : start.getCoordinate();
+        double dx = (place.getLon() - goal.getLon()) * metersPerDegreeLon;
+        double dy = (place.getLat() - goal.getLat()) * metersPerDegreeLat;
+        double best = std::sqrt(dx * dx + dy * dy) / A_STAR_SLACK;
+        if (node < stops.size()) {
+            const double* nodeFrom = &distancesFrom[node * nLandmarks];
+            const double* nodeTo = &distancesTo[node * nLandmarks];
+            for (const auto& landmark: targetRanges) {
+                double from = nodeFrom[std::get<0>(landmark)], to = nodeTo[std::get<0>(landmark)];
+                if (from < INT32_MAX && std::get<1>(landmark) < INT32_MAX) {
+                    best = std::max(best, std::get<1>(landmark) - from);
+                }
+                if (to < INT32_MAX && std::get<2>(landmark) > -INT32_MAX) {
+                    best = std::max(best, to - std::get<2>(landmark));
+                }
+            }
+        }
+        return best;
+    };
 
-        //iterate line neighbours
-        for(auto neighbour: combineAllNeighbours(currentStop.getLineNeighbours(),
-                                                 currentStop.getWalkNeighbours()) ){
-            //get neighbour node itself
-            Stop& neighbourStopCode = std::get<1>(neighbour);
-            //get neighbour code
-            DistancePath& neighbourStop = *std::find(visitedStopsInfo.begin(), visitedStopsInfo.end(), neighbourStopCode.getCode());
+    std::vector<double>& distance = workspace.bestDistance;
+    std::vector<unsigned>& previous = workspace.previous;
+    std::vector<char>& expanded = workspace.visited;
+    //in pair, first the distance plus the bound and after the node, kept as a heap with the smallest on top
+    std::vector<std::pair<double, unsigned>>& nodesToVisit = workspace.heap;
+    std::greater<std::pair<double, unsigned>> heapOrder;
 
-            //if iteratorNeighbours was not visited, visit iteratorNeighbours
-            if(!neighbourStop.isVisited()){
-                neighbourStop.visited();
-                stopsToVisit.push(*std::find(stops.begin(), stops.end(), neighbourStop.getCode()));
-                neighbourStop.setPrevious(currentStop.getCode());
+    workspace.touch(endpoints.source);
+    workspace.touch(endpoints.target);
+    distance[endpoints.source] = 0;
+    nodesToVisit.push_back({bound(endpoints.source), endpoints.source});
+
+    while (!nodesToVisit.empty()) {
+        std::pop_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+        unsigned node = nodesToVisit.back().second;
+        nodesToVisit.pop_back();
+        //the bound is consistent, so the first time a node is expanded its distance is final
+        if (expanded[node]) {
+            continue;
+        }
+        expanded[node] = true;
+        if (node == endpoints.target) {
+            break;
+        }
+        forEachNeighbour(node, endpoints, walkingDistance, false, [&](unsigned neighbour, double weight, unsigned) {
+            workspace.touch(neighbour);
+            weight *= penalty(node, neighbour);
+            if (!expanded[neighbour] && distance[node] + weight < distance[neighbour] &&
+                distance[node] + weight + bound(neighbour) <= limit) {
+                distance[neighbour] = distance[node] + weight;
+                previous[neighbour] = node;
+                nodesToVisit.push_back({distance[neighbour] + bound(neighbour), neighbour});
+                std::push_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
             }
+        });
+    }
+
+    std::vector<unsigned> nodes;
+    if (expanded[endpoints.target]) {
+        for (unsigned current = endpoints.target; current != NO_STOP; current = previous[current]) {
+            nodes.push_back(current);
         }
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    return nodes;
+}
 
-        //if queue is not empty visit the next stop
-        if(!stopsToVisit.empty()){
-            currentCode = find(stops.begin(), stops.end(), stopsToVisit.front())->getCode();
-            stopsToVisit.pop();
-        } else break; //else break from loop
+/**
+ * This method gets different routes between two places, using the walking distance and the services the graph was
+ * connected with
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param nRoutes This is the number of routes wanted
+ * @return It returns the routes found (at most nRoutes, the shortest first), empty if there is no path
+ */
+std::vector<std::list<Stop>> Graph::alternativeRoutes(const Stop &start, const Stop &dest, unsigned nRoutes) const {
+    SearchWorkspace workspace;
+    return alternativeRoutes(start, dest, nRoutes, walkingDistance, services, workspace);
+}
 
-    } while(!stopsToVisit.empty() ||
-            !std::find(visitedStopsInfo.begin(), visitedStopsInfo.end(), dest.getCode())->isVisited());
+/**
+ * This method gets the shortest route between two places and alternatives to it that are meaningfully different
+ * (penalty method): after every A* search the nodes of the path found are marked, and the next search makes the edges
+ * between two marked nodes longer, so it looks for a path that takes other lines or walks elsewhere. A path is only
+ * kept if it is not much longer than the shortest one and does not share most of its length with a route kept before.
+ * The searches do not expand the nodes that can only give paths too long to be kept, and their number is limited, so
+ * the time is a few A* searches
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param nRoutes This is the number of routes wanted
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the searches work on
+ * @return It returns the routes found (at most nRoutes), from the shortest to the longest, empty if there is no path
+ */
+std::vector<std::list<Stop>> Graph::alternativeRoutes(const Stop &start, const Stop &dest, unsigned nRoutes,
+                                                      double walkingDistance, unsigned char services,
+                                                      SearchWorkspace &workspace) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    std::vector<unsigned>& uses = workspace.pathUses;
+    uses.assign(stops.size() + 2, 0);
+    auto penalty = [&](unsigned from, unsigned to) {
+        return 1 + ALTERNATIVE_PENALTY * std::min(uses[from], uses[to]);
+    };
 
+    //in tuple, the length of every route kept, its nodes and its edges (the two nodes of each)
+    std::vector<std::tuple<double, std::vector<unsigned>, std::set<std::pair<unsigned, unsigned>>>> kept;
+    double shortest = INT32_MAX;
+    unsigned mostUses = 0;
+    for (unsigned search = 0; search < nRoutes * ALTERNATIVE_SEARCHES && kept.size() < nRoutes; ++search) {
+        //a path longer than this with the penalties is too long to be kept even without them
+        double limit = search == 0 ? INT32_MAX : ALTERNATIVE_STRETCH * shortest * (1 + ALTERNATIVE_PENALTY * mostUses);
+        std::vector<unsigned> nodes = aStarNodes(endpoints, start, dest, walkingDistance, limit, workspace, penalty);
+        if (nodes.empty()) {
+            break;
+        }
+        //the real length of an edge is its length in the search without its penalty
+        std::vector<double> lengths;
+        double length = 0;
+        for (unsigned i = 1; i < nodes.size(); ++i) {
+            lengths.push_back((workspace.bestDistance[nodes[i]] - workspace.bestDistance[nodes[i - 1]]) /
+                              penalty(nodes[i - 1], nodes[i]));
+            length += lengths.back();
+        }
+        if (search == 0) {
+            shortest = length;
+        }
+
+        bool different = length <= ALTERNATIVE_STRETCH * shortest;
+        for (unsigned r = 0; r < kept.size() && different; ++r) {
+            double shared = 0;
+            for (unsigned i = 1; i < nodes.size(); ++i) {
+                if (std::get<2>(kept[r]).count({nodes[i - 1], nodes[i]})) {
+                    shared += lengths[i - 1];
+                }
+            }
+            different = shared <= ALTERNATIVE_OVERLAP * length;
+        }
+        for (unsigned node: nodes) {
+            mostUses = std::max(mostUses, ++uses[node]);
+        }
+        if (different) {
+            std::set<std::pair<unsigned, unsigned>> edges;
+            for (unsigned i = 1; i < nodes.size(); ++i) {
+                edges.insert({nodes[i - 1], nodes[i]});
+            }
+            kept.emplace_back(length, nodes, edges);
+        }
+    }
 
-    return currentPath(visitedStopsInfo, start, dest);
+    std::sort(kept.begin(), kept.end(), [](const std::tuple<double, std::vector<unsigned>, std::set<std::pair<unsigned, unsigned>>>& a,
+                                           const std::tuple<double, std::vector<unsigned>, std::set<std::pair<unsigned, unsigned>>>& b) {
+        return std::get<0>(a) < std::get<0>(b);
+    });
+    std::vector<std::list<Stop>> routes;
+    for (const auto& route: kept) {
+        routes.emplace_back();
+        for (unsigned node: std::get<1>(route)) {
+            routes.back().push_back(node < stops.size() ? stops[node] : (node == endpoints.source ? start : dest));
+        }
+    }
+    return routes;
+}
+
+/**
+ * This method turns the endpoints of a search into the stops where a path may start and end, for the searches that
+ * work on the stops only (a place that is not a stop starts or ends the path at every stop it can walk to)
+ * @param endpoints This is the endpoints of the search
+ * @param sources This is where the stops a path may start at and the distance to get to them are stored
+ * @param targets This is where the stops a path may end at and the distance from them to the destination are stored
+ * @param direct This is where the distance of the walk between two places that are not stops is stored (INT32_MAX if
+ * they are too far apart)
+ */
+void Graph::splitEndpoints(const Endpoints &endpoints, std::vector<std::pair<unsigned, double>> &sources,
+                           std::vector<std::pair<unsigned, double>> &targets, double &direct) const {
+    sources.clear();
+    targets.clear();
+    direct = INT32_MAX;
+    if (endpoints.source < stops.size()) {
+        sources.emplace_back(endpoints.source, 0);
+    }
+    for (const auto& link: endpoints.sourceLinks) {
+        if (link.first == endpoints.target) {
+            direct = link.second; //the two places are close enough to just walk
+        }
+        else {
+            sources.push_back(link);
+        }
+    }
+    if (endpoints.target < stops.size()) {
+        targets.emplace_back(endpoints.target, 0);
+    }
+    targets.insert(targets.end(), endpoints.targetLinks.begin(), endpoints.targetLinks.end());
+}
+
+/**
+ * This method turns a path of stops found by a search that works on the stops only into the path between the places
+ * @param nodes This is the index of the stops of the path
+ * @param endpoints This is the endpoints of the search
+ * @param start This is the place where the search started
+ * @param dest This is the place the search was trying to get to
+ * @return It returns a list of stops (a path) from the start to the destination, or an empty list if there is no path
+ */
+std::list<Stop> Graph::endpointsPath(const std::vector<unsigned> &nodes, const Endpoints &endpoints,
+                                     const Stop &start, const Stop &dest) const {
+    std::list<Stop> path;
+    if (nodes.empty()) {
+        return path;
+    }
+    if (endpoints.source >= stops.size()) {
+        path.push_back(start);
+    }
+    for (unsigned node: nodes) {
+        path.push_back(stops[node]);
+    }
+    if (endpoints.target >= stops.size()) {
+        path.push_back(dest);
+    }
+    return path;
+}
+
+/**
+ * This method gets the shortest distance between two places taking at most a number of buses with the round based
+ * router, using the walking distance the graph was connected with
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param nLinesToChange This is the maximum number of lines change allowed
+ * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::raptorRoute(const Stop &start, const Stop &dest, const int nLinesToChange) const {
+    SearchWorkspace workspace;
+    return raptorRoute(start, dest, nLinesToChange, walkingDistance, services, workspace);
+}
+
+/**
+ * This method gets the shortest distance between two places taking at most a number of buses with the round based
+ * router, which follows every line in the direction its bus goes (and back, if the graph is not directed). The zones
+ * are not limited, the dijkstra search does that
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param nLinesToChange This is the maximum number of lines change allowed
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::raptorRoute(const Stop &start, const Stop &dest, const int nLinesToChange,
+                                   double walkingDistance, unsigned char services, SearchWorkspace &workspace) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    std::vector<std::pair<unsigned, double>> sources, targets;
+    double direct;
+    splitEndpoints(endpoints, sources, targets, direct);
+
+    unsigned maxBoardings = nLinesToChange >= INT32_MAX - 1 ? INT32_MAX : std::max(nLinesToChange, -1) + 1;
+    std::vector<unsigned> nodes;
+    double distance = raptor.route(sources, targets, maxBoardings, services, walkEdges, walkingDistance, workspace, nodes);
+    if (direct < INT32_MAX && direct <= distance) {
+        return {start, dest};
+    }
+    return endpointsPath(nodes, endpoints, start, dest);
+}
+
+/**
+ * This method gets the earliest arrival between two places leaving at a time, using the walking distance and the
+ * services the graph was connected with
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param departureTime This is the time of departure (in seconds after midnight)
+ * @param arrivalTime This is where the time of arrival is stored (Timetable::NO_TIME if there is no path)
+ * @return It returns a list of stops (the path that arrives first), if there is no path it return an empty list
+ */
+std::list<Stop> Graph::earliestArrival(const Stop &start, const Stop &dest, unsigned departureTime,
+                                       unsigned &arrivalTime) const {
+    SearchWorkspace workspace;
+    return earliestArrival(start, dest, departureTime, walkingDistance, services, workspace, arrivalTime);
+}
+
+/**
+ * This method gets the earliest arrival between two places leaving at a time with the connection scan over the
+ * timetable, only the lines that have a timetable are taken
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param departureTime This is the time of departure (in seconds after midnight)
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @param arrivalTime This is where the time of arrival is stored (Timetable::NO_TIME if there is no path)
+ * @return It returns a list of stops (the path that arrives first), if there is no path it return an empty list
+ */
+std::list<Stop> Graph::earliestArrival(const Stop &start, const Stop &dest, unsigned departureTime,
+                                       double walkingDistance, unsigned char services, SearchWorkspace &workspace,
+                                       unsigned &arrivalTime) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    std::vector<std::pair<unsigned, double>> sources, targets;
+    double direct;
+    splitEndpoints(endpoints, sources, targets, direct);
+
+    std::vector<unsigned> nodes;
+    arrivalTime = timetable.earliestArrival(sources, targets, departureTime, services, walkEdges, walkingDistance,
+                                            workspace, nodes);
+    if (direct < INT32_MAX && departureTime + Timetable::walkingTime(direct) <= arrivalTime) {
+        arrivalTime = departureTime + Timetable::walkingTime(direct);
+        return {start, dest};
+    }
+    return endpointsPath(nodes, endpoints, start, dest);
+}
+
+/**
+ * This method gets every best option between two places leaving in a time window, using the walking distance and the
+ * services the graph was connected with
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param earliest This is the first time of departure of the window (in seconds after midnight)
+ * @param latest This is the last time of departure of the window
+ * @return The return is the departure and arrival times of every best option, from the earliest departure
+ */
+std::vector<std::pair<unsigned, unsigned>> Graph::departureProfile(const Stop &start, const Stop &dest, unsigned earliest,
+                                                                   unsigned latest) const {
+    SearchWorkspace workspace;
+    return departureProfile(start, dest, earliest, latest, walkingDistance, services, workspace);
+}
+
+/**
+ * This method gets every best option between two places leaving in a time window (no other option leaves later and
+ * arrives earlier) with one backward scan of the timetable, instead of one earliest arrival search for every time of
+ * the window. The path of an option is the one earliestArrival finds leaving at its departure time. An option that
+ * takes longer than walking straight to the destination is left out
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param earliest This is the first time of departure of the window (in seconds after midnight)
+ * @param latest This is the last time of departure of the window
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return The return is the departure and arrival times of every best option, from the earliest departure
+ */
+std::vector<std::pair<unsigned, unsigned>> Graph::departureProfile(const Stop &start, const Stop &dest, unsigned earliest,
+                                                                   unsigned latest, double walkingDistance,
+                                                                   unsigned char services,
+                                                                   SearchWorkspace &workspace) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    std::vector<std::pair<unsigned, double>> sources, targets;
+    double direct;
+    splitEndpoints(endpoints, sources, targets, direct);
+
+    std::vector<std::pair<unsigned, unsigned>> options = timetable.profile(sources, targets, earliest, latest, services,
+                                                                           walkEdges, walkingDistance, workspace);
+    if (direct < INT32_MAX) {
+        unsigned walk = Timetable::walkingTime(direct);
+        options.erase(std::remove_if(options.begin(), options.end(), [walk](const std::pair<unsigned, unsigned>& option) {
+            return option.second - option.first >= walk;
+        }), options.end());
+    }
+    return options;
+}
+
+/**
+ * This method checks if any line of the graph has a timetable
+ * @return The return is true if the earliest arrival searches can take a bus
+ */
+bool Graph::hasTimetable() const {
+    return timetable.getNumberConnections() > 0;
+}
+
+/**
+ * This method gets the shortest distance between two places on the contraction hierarchy, using the walking distance
+ * the graph was connected with
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @return It returns a list of stops (the shortest path), if there is no path it return an empty list
+ */
+std::list<Stop> Graph::hierarchyRoute(const Stop &start, const Stop &dest) const {
+    SearchWorkspace workspace;
+    return hierarchyRoute(start, dest, walkingDistance, services, workspace);
+}
+
+/**
+ * This method gets the shortest distance between two places on the contraction hierarchy built for the walking
+ * distance and the services (see hasContractionHierarchy), a place that is not a stop starts (or ends) the search at
+ * every stop it can walk to
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param walkingDistance This is the maximum distance to walk between a place that is not a stop and a stop
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (the shortest path), if there is no path or no hierarchy for the walking distance
+ * and the services it return an empty list
+ */
+std::list<Stop> Graph::hierarchyRoute(const Stop &start, const Stop &dest, double walkingDistance,
+                                      unsigned char services, SearchWorkspace &workspace) const {
+    const ContractionHierarchy* hierarchy = findHierarchy(walkingDistance, services);
+    if (hierarchy == nullptr) {
+        return {};
+    }
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    std::vector<std::pair<unsigned, double>> sources, targets;
+    double direct;
+    splitEndpoints(endpoints, sources, targets, direct);
+
+    std::vector<unsigned> nodes;
+    double distance = hierarchy->route(sources, targets, workspace, nodes);
+    if (direct < INT32_MAX && direct <= distance) {
+        return {start, dest};
+    }
+    return endpointsPath(nodes, endpoints, start, dest);
+}
+
+/**
+ * This method gets the shortest distance between two places with a dijkstra search from both ends at the same time,
+ * the side with the closest node is expanded next. Every time a side reaches a node the other side already reached, a
+ * path through that node is found; the search stops when the closest nodes of both sides are together as far as the
+ * best path found, because no path that was not found yet can be shorter. Usually each side only gets halfway, so
+ * about half of the nodes are settled
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (the shortest path), if there is no path it return an empty list
+ */
+std::list<Stop> Graph::bidirectionalDijkstra(const Stop &start, const Stop &dest, double walkingDistance,
+                                             unsigned char services, SearchWorkspace &workspace) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    workspace.prepare(stops.size() + 2); //the stops and the two virtual endpoints
+    std::greater<std::pair<double, unsigned>> heapOrder;
+
+    double bestPath = INT32_MAX;
+    unsigned meeting = NO_STOP;
+    workspace.touch(endpoints.source);
+    workspace.touch(endpoints.target);
+    workspace.bestDistance[endpoints.source] = 0;
+    workspace.backwardDistance[endpoints.target] = 0;
+    workspace.heap.push_back({0, endpoints.source});
+    workspace.backwardHeap.push_back({0, endpoints.target});
+    if (endpoints.source == endpoints.target) {
+        bestPath = 0;
+        meeting = endpoints.source;
+    }
+
+    while (!workspace.heap.empty() && !workspace.backwardHeap.empty()) {
+        double forwardTop = workspace.heap.front().first;
+        double backwardTop = workspace.backwardHeap.front().first;
+        if (forwardTop + backwardTop >= bestPath) {
+            break;
+        }
+        bool backward = backwardTop < forwardTop;
+        //the side being expanded and the other side
+        std::vector<std::pair<double, unsigned>>& nodesToVisit = backward ? workspace.backwardHeap : workspace.heap;
+        std::vector<double>& distance = backward ? workspace.backwardDistance : workspace.bestDistance;
+        std::vector<unsigned>& previous = backward ? workspace.backwardPrevious : workspace.previous;
+        const std::vector<double>& otherDistance = backward ? workspace.bestDistance : workspace.backwardDistance;
+
+        std::pop_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+        std::pair<double, unsigned> top = nodesToVisit.back();
+        nodesToVisit.pop_back();
+        unsigned node = top.second;
+        if (top.first > distance[node]) {
+            continue;
+        }
+        forEachNeighbour(node, endpoints, walkingDistance, backward, [&](unsigned neighbour, double weight, unsigned) {
+            workspace.touch(neighbour);
+            if (distance[node] + weight < distance[neighbour]) {
+                distance[neighbour] = distance[node] + weight;
+                previous[neighbour] = node;
+                nodesToVisit.push_back({distance[neighbour], neighbour});
+                std::push_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+                if (distance[neighbour] + otherDistance[neighbour] < bestPath) {
+                    bestPath = distance[neighbour] + otherDistance[neighbour];
+                    meeting = neighbour;
+                }
+            }
+        });
+    }
+    return meetingPath(meeting, endpoints, workspace, start, dest);
+}
+
+/**
+ * This method calculates the path with the least number of stops between two places with a BFS from both ends at the
+ * same time. A whole level of the side with less nodes waiting is visited at a time, and the search stops after the
+ * first level that reaches a node the other side already visited (the shortest of the paths found in that level)
+ * @param start This is the place (stop or coordinate) where the graph will start searching
+ * @param dest This is the destination place (stop or coordinate), where we are trying to get to
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (a path) that best match the description, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::bidirectionalBFS(const Stop &start, const Stop &dest, double walkingDistance,
+                                        unsigned char services, SearchWorkspace &workspace) const {
+    Endpoints endpoints = findEndpoints(start, dest, walkingDistance, services);
+    workspace.prepare(stops.size() + 2); //the stops and the two virtual endpoints
+    std::vector<char>& visited = workspace.visited;
+
+    workspace.touch(endpoints.source);
+    workspace.touch(endpoints.target);
+    //the number of edges from the start (or to the destination) is kept as the distance
+    workspace.bestDistance[endpoints.source] = 0;
+    workspace.backwardDistance[endpoints.target] = 0;
+    visited[endpoints.source] |= SearchWorkspace::FORWARD;
+    visited[endpoints.target] |= SearchWorkspace::BACKWARD;
+    workspace.fifo.push_back(endpoints.source);
+    workspace.backwardFifo.push_back(endpoints.target);
+    size_t forwardHead = 0, backwardHead = 0;
+
+    double bestPath = INT32_MAX;
+    unsigned meeting = NO_STOP;
+    if (endpoints.source == endpoints.target) {
+        bestPath = 0;
+        meeting = endpoints.source;
+    }
+
+    while (meeting == NO_STOP && forwardHead < workspace.fifo.size() && backwardHead < workspace.backwardFifo.size()) {
+        bool backward = workspace.backwardFifo.size() - backwardHead < workspace.fifo.size() - forwardHead;
+        std::vector<unsigned>& stopsToVisit = backward ? workspace.backwardFifo : workspace.fifo;
+        size_t& head = backward ? backwardHead : forwardHead;
+        std::vector<double>& distance = backward ? workspace.backwardDistance : workspace.bestDistance;
+        std::vector<unsigned>& previous = backward ? workspace.backwardPrevious : workspace.previous;
+        const std::vector<double>& otherDistance = backward ? workspace.bestDistance : workspace.backwardDistance;
+        char side = backward ? SearchWorkspace::BACKWARD : SearchWorkspace::FORWARD;
+
+        //the nodes waiting are all in the same level
+        size_t levelEnd = stopsToVisit.size();
+        while (head < levelEnd) {
+            unsigned currentIndex = stopsToVisit[head++];
+            forEachNeighbour(currentIndex, endpoints, walkingDistance, backward, [&](unsigned neighbour, double, unsigned) {
+                workspace.touch(neighbour);
+                if (visited[neighbour] & side) {
+                    return;
+                }
+                visited[neighbour] |= side;
+                distance[neighbour] = distance[currentIndex] + 1;
+                previous[neighbour] = currentIndex;
+                stopsToVisit.push_back(neighbour);
+                if (distance[neighbour] + otherDistance[neighbour] < bestPath) {
+                    bestPath = distance[neighbour] + otherDistance[neighbour];
+                    meeting = neighbour;
+                }
+            });
+        }
+    }
+    return meetingPath(meeting, endpoints, workspace, start, dest);
+}
+
+/**
+ * This method joins the two halves of the path found by a bidirectional search
+ * @param meeting This is the node where the two sides of the search met, or NO_STOP if they did not meet
+ * @param endpoints This is the endpoints of the search
+ * @param workspace This is the memory the search worked on
+ * @param start This is the place where the search started
+ * @param dest This is the place the search was trying to get to
+ * @return It returns a list of stops (a path) from the start to the destination, or an empty list if there is no path
+ */
+std::list<Stop> Graph::meetingPath(unsigned meeting, const Endpoints &endpoints, const SearchWorkspace &workspace,
+                                   const Stop &start, const Stop &dest) const {
+    std::list<Stop> path;
+    if (meeting == NO_STOP) {
+        return path;
+    }
+    auto stopAt = [&](unsigned node) {
+        return node < stops.size() ? stops[node] : (node == endpoints.source ? start : dest);
+    };
+    for (unsigned current = meeting; current != NO_STOP; current = workspace.previous[current]) {
+        path.push_front(stopAt(current));
+    }
+    for (unsigned current = workspace.backwardPrevious[meeting]; current != NO_STOP; current = workspace.backwardPrevious[current]) {
+        path.push_back(stopAt(current));
+    }
+    return path;
+}
+
+/**
+ * This method finds the shortest path from one place to every stop (one to all dijkstra), so the routes to many
+ * destinations from the same place cost a single search. The result stays in the workspace until its next search: the
+ * distance and the previous node of a stop are at its index, a place that is not a stop is the node stops.size()
+ * @param start This is the place (stop or coordinate) where the paths start
+ * @param walkingDistance This is the maximum distance to walk between stops (only the walking edges that were
+ * precomputed can be used)
+ * @param services This is the bitmask of the service periods of the lines that can be taken
+ * @param workspace This is the memory the search works on, where the tree is left
+ * @param reverse This is true to find the shortest paths from every stop to the place instead (the previous node of a
+ * stop is then the next one on its path)
+ */
+void Graph::shortestPathTree(const Stop &start, double walkingDistance, unsigned char services,
+                             SearchWorkspace &workspace, bool reverse) const {
+    //a tree has no destination, a reverse tree is grown from the target side and has no source
+    Endpoints endpoints;
+    endpoints.services = services;
+    unsigned source = getStopIndex(start.getCode());
+    std::vector<std::pair<unsigned, double>> links;
+    if (source == NO_STOP) {
+        source = stops.size();
+        links = stopsWithinRadius(start.getCoordinate(), walkingDistance);
+        std::sort(links.begin(), links.end());
+    }
+    endpoints.source = reverse ? NO_STOP : source;
+    endpoints.target = reverse ? source : NO_STOP;
+    (reverse ? endpoints.targetLinks : endpoints.sourceLinks) = links;
+    workspace.prepare(stops.size() + 1); //the stops and the virtual source
+
+    std::vector<double>& distance = workspace.bestDistance;
+    std::vector<unsigned>& previous = workspace.previous;
+    //in pair, first the distance and after the node, kept as a heap with the smallest on top
+    std::vector<std::pair<double, unsigned>>& nodesToVisit = workspace.heap;
+    std::greater<std::pair<double, unsigned>> heapOrder;
+
+    workspace.touch(source);
+    distance[source] = 0;
+    nodesToVisit.push_back({0, source});
+
+    while (!nodesToVisit.empty()) {
+        std::pop_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+        std::pair<double, unsigned> top = nodesToVisit.back();
+        nodesToVisit.pop_back();
+        unsigned node = top.second;
+        //a node is pushed again every time its distance improves, only the last one is expanded
+        if (top.first > distance[node]) {
+            continue;
+        }
+
+        forEachNeighbour(node, endpoints, walkingDistance, reverse, [&](unsigned neighbour, double weight, unsigned) {
+            workspace.touch(neighbour);
+            if (distance[node] + weight < distance[neighbour]) {
+                distance[neighbour] = distance[node] + weight;
+                previous[neighbour] = node;
+                nodesToVisit.push_back({distance[neighbour], neighbour});
+                std::push_heap(nodesToVisit.begin(), nodesToVisit.end(), heapOrder);
+            }
+        });
+    }
+}
+
+/**
+ * This method gets the path to a stop from a shortest path tree
+ * @param start This is the place the tree was built from
+ * @param node This is the index of the stop the path goes to
+ * @param workspace This is the workspace where the tree was left by shortestPathTree
+ * @return It returns a list of stops (a path) from the start to the stop, if the stop was not reached it return an empty
+ * list (the path of a reverse tree goes from the stop to the start, so the list has to be read from its end)
+ */
+std::list<Stop> Graph::treePath(const Stop &start, unsigned node, const SearchWorkspace &workspace) const {
+    std::list<Stop> path;
+    if (!workspace.isReached(node)) {
+        return path;
+    }
+    for (unsigned current = node; current != NO_STOP; current = workspace.getPrevious(current)) {
+        path.push_front(current < stops.size() ? stops[current] : start);
+    }
+    return path;
+}
+
+/**
+ * This method searches one route with the search the user prefers, a request that was already searched since the graph
+ * last changed is answered by the route cache
+ * @param query This is the request with the endpoints, the preferences and the limits of the route
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (a path) that best match the request, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::route(const RouteQuery &query, SearchWorkspace &workspace) const {
+    std::list<Stop> path;
+    if (routeCache.find(query, path)) {
+        return path;
+    }
+    path = searchRoute(query, workspace);
+    routeCache.insert(query, path);
+    return path;
+}
+
+/**
+ * This method searches one route on the graph with the search that best fits the preference and the limits of the
+ * request
+ * @param query This is the request with the endpoints, the preferences and the limits of the route
+ * @param workspace This is the memory the search works on
+ * @return It returns a list of stops (a path) that best match the request, if there is no path it return an empty list
+ */
+std::list<Stop> Graph::searchRoute(const RouteQuery &query, SearchWorkspace &workspace) const {
+    //the searches without limits can use the contraction hierarchy or the A* bounds
+    switch (query.searchType) {
+        case RouteQuery::LEAST_STOPS:
+            return bidirectionalBFS(query.start, query.dest, query.walkingDistance, query.services, workspace);
+        default:
+            if (query.nLinesToChange == INT32_MAX && query.nZones >= (int) nZoneIds) {
+                if (hasContractionHierarchy(query.walkingDistance, query.services)) {
+                    return hierarchyRoute(query.start, query.dest, query.walkingDistance, query.services, workspace);
+                }
+                return aStar(query.start, query.dest, query.walkingDistance, query.services, workspace);
+            }
+            //only the number of lines is limited, the rounds of the round based router are the buses taken
+            if (query.nZones >= (int) nZoneIds) {
+                return raptorRoute(query.start, query.dest, query.nLinesToChange, query.walkingDistance, query.services,
+                                   workspace);
+            }
+            return dijkstra(query.start, query.dest, query.nLinesToChange, query.nZones, query.walkingDistance,
+                            query.services, workspace);
+    }
+}
+
+/**
+ * This method searches many routes at once, the queries are shared by a pool of threads that search the graph at the
+ * same time (the graph is only read), each with its own workspace
+ * @param queries This is the list of requests
+ * @param nThreads This is the number of threads to use, 0 uses one for every core
+ * @return The return is the path of every request, in the same order as the requests
+ */
+std::vector<std::list<Stop>> Graph::batchRoutes(const std::vector<RouteQuery> &queries, unsigned nThreads) const {
+    std::vector<std::list<Stop>> results(queries.size());
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<size_t>(nThreads, std::max<size_t>(1, queries.size()));
+
+    //every thread takes the next query that no one took yet, so a slow query does not hold the others
+    std::atomic<size_t> nextQuery(0);
+    auto worker = [&]() {
+        SearchWorkspace workspace;
+        for (size_t i = nextQuery++; i < queries.size(); i = nextQuery++) {
+            results[i] = route(queries[i], workspace);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < nThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    return results;
+}
+
+/**
+ * This method gets the cache of the paths found by route, to read how many requests it answered
+ * @return the attribute routeCache
+ */
+const RouteCache &Graph::getRouteCache() const {
+    return routeCache;
+}
+
+/**
+ * This method builds the landmark table used by the A* search. The landmarks are spread over the biggest connected
+ * part of the graph (every new one is the stop farthest from the ones already chosen) and the distances from each of
+ * them to every stop and back are found by one to all searches shared by a pool of threads
+ * @param nLandmarks This is the number of landmarks
+ * @param walkingDistance This is the longest walking distance of the searches that will use the table (a bigger one
+ * makes the bounds worse)
+ * @param services This is the bitmask of the service periods of the searches that will use the table (more services
+ * make the bounds worse)
+ * @param nThreads This is the number of threads to use, 0 uses one for every core
+ */
+void Graph::buildLandmarks(unsigned nLandmarks, double walkingDistance, unsigned char services, unsigned nThreads) {
+    walkingDistance = std::min(walkingDistance, walkLayerDistance);
+    nLandmarks = std::min<unsigned>(nLandmarks, stops.size());
+    landmarks = Landmarks();
+    if (nLandmarks == 0) {
+        return;
+    }
+
+    //the landmarks are only useful in the biggest connected part, a BFS from every stop not reached yet finds them (it
+    //follows the edges both ways, a directed graph may not have a path back)
+    std::vector<unsigned> component(stops.size(), NO_STOP);
+    unsigned biggest = 0, biggestSize = 0;
+    Endpoints none = {NO_STOP, NO_STOP, {}, {}, services};
+    std::vector<unsigned> stopsToVisit;
+    for (unsigned first = 0; first < stops.size(); ++first) {
+        if (component[first] != NO_STOP) continue;
+        stopsToVisit.assign(1, first);
+        component[first] = first;
+        for (size_t head = 0; head < stopsToVisit.size(); ++head) {
+            auto visit = [&](unsigned neighbour, double, unsigned) {
+                if (component[neighbour] == NO_STOP) {
+                    component[neighbour] = first;
+                    stopsToVisit.push_back(neighbour);
+                }
+            };
+            forEachNeighbour(stopsToVisit[head], none, walkingDistance, false, visit);
+            forEachNeighbour(stopsToVisit[head], none, walkingDistance, true, visit);
+        }
+        if (stopsToVisit.size() > biggestSize) {
+            biggest = first;
+            biggestSize = stopsToVisit.size();
+        }
+    }
+
+    //farthest point selection, starting with the stop farthest from the center of the biggest part
+    double centerLat = 0, centerLon = 0;
+    for (unsigned i = 0; i < stops.size(); ++i) {
+        if (component[i] == biggest) {
+            centerLat += stops[i].getCoordinate().getLat() / biggestSize;
+            centerLon += stops[i].getCoordinate().getLon() / biggestSize;
+        }
+    }
+    Coordinate center(centerLat, centerLon);
+    std::vector<double> closestLandmark(stops.size(), INT32_MAX);
+    std::vector<unsigned> chosen;
+    for (unsigned k = 0; k < std::min(nLandmarks, biggestSize); ++k) {
+        unsigned farthest = NO_STOP;
+        double farthestDistance = -1;
+        for (unsigned i = 0; i < stops.size(); ++i) {
+            if (component[i] != biggest) continue;
+            double distance = chosen.empty() ? stops[i].getCoordinate().haversine(center) : closestLandmark[i];
+            if (distance > farthestDistance) {
+                farthest = i;
+                farthestDistance = distance;
+            }
+        }
+        chosen.push_back(farthest);
+        for (unsigned i = 0; i < stops.size(); ++i) {
+            closestLandmark[i] = std::min(closestLandmark[i], stops[i].distance(stops[farthest]));
+        }
+    }
+
+    //two searches for every landmark (from it and to it), every thread takes the next search that no one took yet
+    std::vector<double> distancesFrom(stops.size() * chosen.size());
+    std::vector<double> distancesTo(stops.size() * chosen.size());
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<size_t>(nThreads, 2 * chosen.size());
+    std::atomic<unsigned> nextSearch(0);
+    auto worker = [&]() {
+        SearchWorkspace workspace;
+        for (unsigned search = nextSearch++; search < 2 * chosen.size(); search = nextSearch++) {
+            unsigned k = search / 2;
+            bool reverse = search % 2 == 1;
+            shortestPathTree(stops[chosen[k]], walkingDistance, services, workspace, reverse);
+            std::vector<double>& distances = reverse ? distancesTo : distancesFrom;
+            for (unsigned i = 0; i < stops.size(); ++i) {
+                distances[i * chosen.size() + k] = workspace.getDistance(i);
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < nThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    landmarks = Landmarks(chosen, distancesFrom, distancesTo, walkingDistance, services);
+}
+
+/**
+ * This method builds the contraction hierarchy of the graph for a fixed walking distance and service periods, the
+ * hierarchy gives the same paths as the dijkstra search for them but a lot faster. A hierarchy built before for the
+ * same services is replaced, the ones of other services are kept. They must be built again if the stops change
+ * @param walkingDistance This is the walking distance of the searches that will use the hierarchy
+ * @param services This is the bitmask of the service periods of the searches that will use the hierarchy
+ */
+void Graph::buildContractionHierarchy(double walkingDistance, unsigned char services) {
+    walkingDistance = std::min(walkingDistance, walkLayerDistance);
+    std::vector<Adjacency::Edge> edges;
+    Endpoints none = {NO_STOP, NO_STOP, {}, {}, services};
+    for (unsigned node = 0; node < stops.size(); ++node) {
+        forEachNeighbour(node, none, walkingDistance, false, [&](unsigned neighbour, double weight, unsigned line) {
+            edges.push_back({node, neighbour, weight, line});
+        });
+    }
+    hierarchies.erase(std::remove_if(hierarchies.begin(), hierarchies.end(), [&](const ContractionHierarchy& hierarchy) {
+        return hierarchy.getServices() == services;
+    }), hierarchies.end());
+    hierarchies.emplace_back(stops.size(), edges, walkingDistance, services);
+}
+
+/**
+ * This method finds the contraction hierarchy a search can use
+ * @param walkingDistance This is the walking distance of the search
+ * @param services This is the bitmask of the service periods of the search
+ * @return The return is the hierarchy built for the walking distance and the services, nullptr if there is none
+ */
+const ContractionHierarchy *Graph::findHierarchy(double walkingDistance, unsigned char services) const {
+    walkingDistance = std::min(walkingDistance, walkLayerDistance);
+    for (const auto& hierarchy: hierarchies) {
+        if (hierarchy.getServices() == services && hierarchy.getWalkingDistance() == walkingDistance) {
+            return &hierarchy;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * This method checks if the graph has a contraction hierarchy that can be used by a search
+ * @param walkingDistance This is the walking distance of the search
+ * @param services This is the bitmask of the service periods of the search
+ * @return The return is true if there is a hierarchy built for the walking distance and the services
+ */
+bool Graph::hasContractionHierarchy(double walkingDistance, unsigned char services) const {
+    return findHierarchy(walkingDistance, services) != nullptr;
+}
+
+/**
+ * This method writes the built graph to a snapshot file: the stops, the interned line codes, the line and walking
+ * edges, the routes, the timetable and the contraction hierarchies. Loading it gives the same graph without reading the dataset or
+ * contracting again (the landmark table has its own file)
+ * @param path This is the path of the file
+ * @param datasetStamp This is the stamp of the dataset files the graph was built from (Reader::datasetStamp)
+ * @return The return is true if the file was written
+ */
+bool Graph::saveSnapshot(const std::string &path, uint64_t datasetStamp) const {
+    Snapshot snapshot;
+    snapshot.put(datasetStamp);
+    snapshot.put<uint32_t>(stops.size());
+    for (const auto& stop: stops) {
+        snapshot.putString(stop.getCode());
+        snapshot.putString(stop.getName());
+        snapshot.putString(stop.getZone());
+        snapshot.put(stop.getCoordinate().getLat());
+        snapshot.put(stop.getCoordinate().getLon());
+        snapshot.put(stop.getZoneId());
+    }
+    snapshot.put<uint32_t>(lineCodes.size());
+    for (const auto& code: lineCodes) {
+        snapshot.putString(code);
+    }
+    snapshot.put<unsigned char>(directed);
+    lineEdges.save(snapshot);
+    walkEdges.save(snapshot);
+    snapshot.put(walkLayerDistance);
+    raptor.save(snapshot);
+    timetable.save(snapshot);
+    snapshot.put<uint32_t>(hierarchies.size());
+    for (const auto& hierarchy: hierarchies) {
+        hierarchy.save(snapshot);
+    }
+    return snapshot.save(path);
+}
+
+/**
+ * This method replaces the graph with the one in a snapshot file written by saveSnapshot, the file is mapped and its
+ * arrays copied as they are (nothing is parsed). The graph is only replaced if the file is complete and consistent,
+ * and if it was built from the same dataset files
+ * @param path This is the path of the file
+ * @param datasetStamp This is the stamp of the dataset files as they are now (Reader::datasetStamp)
+ * @return The return is true if the graph was loaded
+ */
+bool Graph::loadSnapshot(const std::string &path, uint64_t datasetStamp) {
+    Snapshot snapshot;
+    uint64_t readStamp;
+    if (!snapshot.map(path) || !snapshot.get(readStamp) || readStamp != datasetStamp) {
+        return false;
+    }
+    Graph read;
+    uint32_t nStops, nLineCodes, nHierarchies;
+    unsigned char readDirected;
+    //the counts are checked against the bytes left before anything is allocated, a corrupted count is refused
+    if (!snapshot.get(nStops) || nStops > snapshot.getRemaining() / SNAPSHOT_STOP_SIZE) {
+        return false;
+    }
+    read.stops.reserve(nStops);
+    for (uint32_t i = 0; i < nStops; ++i) {
+        std::string code, name, zone;
+        double lat, lon;
+        unsigned zoneId;
+        if (!snapshot.getString(code) || !snapshot.getString(name) || !snapshot.getString(zone) ||
+            !snapshot.get(lat) || !snapshot.get(lon) || !snapshot.get(zoneId)) {
+            return false;
+        }
+        read.stops.emplace_back(code, name, zone, Coordinate(lat, lon));
+        read.stops.back().setZoneId(zoneId);
+    }
+    if (!snapshot.get(nLineCodes) || nLineCodes > snapshot.getRemaining() / sizeof(uint32_t)) {
+        return false;
+    }
+    read.lineCodes.resize(nLineCodes);
+    for (auto& code: read.lineCodes) {
+        if (!snapshot.getString(code)) {
+            return false;
+        }
+    }
+    if (!snapshot.get(readDirected) || !read.lineEdges.load(snapshot) || !read.walkEdges.load(snapshot) ||
+        !snapshot.get(read.walkLayerDistance) || !read.raptor.load(snapshot, read.stops) ||
+        !read.timetable.load(snapshot, nStops) || !snapshot.get(nHierarchies)) {
+        return false;
+    }
+    read.hierarchies.resize(nHierarchies);
+    for (auto& hierarchy: read.hierarchies) {
+        if (!hierarchy.load(snapshot) || hierarchy.getNumberNodes() != nStops) {
+            return false;
+        }
+    }
+    if (read.lineEdges.getNumberNodes() != nStops || read.walkEdges.getNumberNodes() != nStops) {
+        return false;
+    }
+    for (unsigned line: read.lineEdges.getLines()) {
+        if (line >= nLineCodes) {
+            return false;
+        }
+    }
+    read.directed = readDirected;
+    read.reverseLineEdges = read.lineEdges.reversed();
+    read.indexStops();
+    *this = std::move(read);
+    return true;
+}
+
+/**
+ * This method calculates a fingerprint of the stops (their codes and coordinates, which place the walking edges) and
+ * of the line edges of the graph, a saved landmark table is only loaded on a graph with the same fingerprint (FNV-1a
+ * hash)
+ * @return The return is the fingerprint
+ */
+uint64_t Graph::fingerprint() const {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    for (const auto& stop: stops) {
+        add(stop.getCode().data(), stop.getCode().size() + 1);
+        double coordinates[2] = {stop.getCoordinate().getLat(), stop.getCoordinate().getLon()};
+        add(coordinates, sizeof(coordinates));
+    }
+    add(lineEdges.getOffsets().data(), lineEdges.getOffsets().size() * sizeof(unsigned));
+    add(lineEdges.getTargets().data(), lineEdges.getTargets().size() * sizeof(unsigned));
+    add(lineEdges.getWeights().data(), lineEdges.getWeights().size() * sizeof(double));
+    add(lineEdges.getServices().data(), lineEdges.getServices().size() * sizeof(unsigned char));
+    return hash;
+}
+
+/**
+ * This method writes the landmark table of the graph to a file
+ * @param path This is the path of the file
+ * @return The return is true if the file was written
+ */
+bool Graph::saveLandmarks(const std::string &path) const {
+    return landmarks.save(path, fingerprint());
+}
+
+/**
+ * This method reads the landmark table of the graph from a file, it is only loaded if it was saved from the same graph
+ * @param path This is the path of the file
+ * @return The return is true if the table was loaded
+ */
+bool Graph::loadLandmarks(const std::string &path) {
+    return landmarks.load(path, fingerprint(), stops.size());
+}
+
+/**
+ * This method gets the landmark table of the graph
+ * @return The return is the landmark table (empty if it was not built)
+ */
+const Landmarks &Graph::getLandmarks() const {
+    return landmarks;
 }
 
 /**
@@ -188,41 +1642,56 @@ const std::vector<Stop> &Graph::getStops() const {
 }
 
 /**
- * This method constructs the path by starting at the destination and building the path backwards until it reaches the
- * the start (by following its predecessor)
- * @param distPath  This is a vector where the information the stop we are currently looking and the its predecessor is located
- * @param start This is the start of the path we are trying to find (found last)
- * @param dest This is the destination of the path, (where we start rebuilding the path)
- * @return The return is  a list of the stop (the path) from start to dest, if there is not path ir returns am empty list
+ * This method (re)builds the table that maps the code of every stop to its position in the graph, the list of the
+ * interned zone of every stop and the spatial index over their coordinates
  */
-std::list<Stop> Graph::currentPath(const std::vector<DistancePath>& distPath, const Stop& start, const Stop& dest){
-    std::list<Stop> path;
-    std::string addedPath;
-    if( std::find(distPath.begin(), distPath.end(), dest.getCode())->isVisited() ) {
-        path.push_back(dest);
-        addedPath = std::find(distPath.begin(), distPath.end(), dest.getCode())->getPrevious();
-        while (path.front() != start) {
-            auto it = std::find(stops.begin(), stops.end(), addedPath);
-            Stop test = *it;
-            path.push_front( test );
-            addedPath = std::find(distPath.begin(), distPath.end(), addedPath)->getPrevious();
+void Graph::indexStops() {
+    stopIndex.clear();
+    stopIndex.reserve(stops.size());
+    stopZones.clear();
+    nZoneIds = 0;
+    std::vector<Coordinate> coordinates;
+    coordinates.reserve(stops.size());
+    for (unsigned i = 0; i < stops.size(); ++i) {
+        stopIndex[stops[i].getCode()] = i;
+        coordinates.push_back(stops[i].getCoordinate());
+        stopZones.push_back(stops[i].getZoneId());
+        if (stops[i].getZoneId() != Stop::NO_ZONE) {
+            nZoneIds = std::max(nZoneIds, stops[i].getZoneId() + 1);
         }
     }
-    return path;
+    stopGrid = SpatialGrid(coordinates, STOP_GRID_CELL_SIZE);
+}
+
+/**
+ * This method gets the position of a stop in the graph
+ * @param code This is the code of the stop
+ * @return The return is the index of the stop, or NO_STOP if there is no stop with that code
+ */
+unsigned Graph::getStopIndex(const std::string &code) const {
+    auto it = stopIndex.find(code);
+    return it == stopIndex.end() ? NO_STOP : it->second;
 }
 
 /**
- * This method combines two lists of neighbours into one
- * @param lineNeighbours This is the first list of neighbour to be combined
- * @param walkNeighbours This is the second list of neighbour to be combined
- * @return This returns a list of neighbours that is the combination the the two received lists
+ * This method finds the stops that are inside a circle
+ * @param center This is the center of the circle
+ * @param radius This is the radius of the circle in meters
+ * @return The return is a vector with the index of every stop inside the circle and its distance to the center
  */
-std::list<std::tuple<double, Stop&, std::string>> Graph::combineAllNeighbours(const std::list<std::tuple<double, Stop&, std::string>>& lineNeighbours,
-                                                                              const std::list<std::tuple<double, Stop&, std::string>>& walkNeighbours){
-    std::list<std::tuple<double, Stop&, std::string>> combinedList;
-    copy(lineNeighbours.rbegin(), lineNeighbours.rend(), front_inserter(combinedList));
-    copy(walkNeighbours.rbegin(), walkNeighbours.rend(), front_inserter(combinedList));
-    return combinedList;
+std::vector<std::pair<unsigned, double>> Graph::stopsWithinRadius(const Coordinate &center, double radius) const {
+    return stopGrid.withinRadius(center, radius);
+}
+
+/**
+ * This method finds the stops that are closer to a coordinate
+ * @param center This is the coordinate
+ * @param k This is the number of stops to find
+ * @return The return is a vector with the index of the k closer stops and their distance to the center, from the
+ * closer to the farthest
+ */
+std::vector<std::pair<unsigned, double>> Graph::nearestStops(const Coordinate &center, unsigned k) const {
+    return stopGrid.nearest(center, k);
 }
 
 /**
@@ -233,7 +1702,14 @@ void Graph::addStops(std::vector<Stop> newStop) {
     for (const auto& newStop : newStop) {
         stops.push_back(newStop);
     }
-    connectWalkStop(walkingDistance);
+    indexStops();
+    landmarks = Landmarks();
+    hierarchies.clear();
+    routeCache.clear();
+    lineEdges.addNodes(newStop.size());
+    reverseLineEdges.addNodes(newStop.size());
+    raptor = Raptor(stops, raptor.getRoutes(), raptor.getRouteServices());
+    precomputeWalkEdges(walkLayerDistance);
 }
 
 /**
@@ -241,31 +1717,105 @@ void Graph::addStops(std::vector<Stop> newStop) {
  * @param codes a vector of strings that represent codes
  */
 void Graph::removeStop(std::vector<std::string> codes) {
+    //newIndex has the position every stop will have after the removal, or NO_STOP if it is removed
+    std::vector<unsigned> newIndex(stops.size());
     for (const auto& code: codes) {
-        for (const auto& currstop : stops){
-            if (currstop.getCode() == code)
-            {
-                std::remove(stops.begin(), stops.end(), currstop);
-                break;
+        unsigned index = getStopIndex(code);
+        if (index != NO_STOP) {
+            newIndex[index] = NO_STOP;
+        }
+    }
+    std::vector<Stop> keptStops;
+    for (unsigned i = 0; i < stops.size(); ++i) {
+        if (newIndex[i] != NO_STOP) {
+            newIndex[i] = keptStops.size();
+            keptStops.push_back(stops[i]);
+        }
+    }
+    stops = keptStops;
+    indexStops();
+    landmarks = Landmarks();
+    hierarchies.clear();
+    routeCache.clear();
+
+    std::vector<Adjacency::Edge> edges;
+    for (const auto& edge: lineEdges.getEdges()) {
+        if (newIndex[edge.from] != NO_STOP && newIndex[edge.to] != NO_STOP) {
+            edges.push_back({newIndex[edge.from], newIndex[edge.to], edge.weight, edge.line, edge.services});
+        }
+    }
+    lineEdges = Adjacency(stops.size(), edges);
+    reverseLineEdges = lineEdges.reversed();
+
+    //a route is split where a stop was removed, like its edges, and the parts keep the services of the route
+    std::vector<std::vector<unsigned>> oldRoutes = raptor.getRoutes();
+    std::vector<std::vector<unsigned>> routes;
+    std::vector<unsigned char> routeServices;
+    std::vector<unsigned> part;
+    for (unsigned r = 0; r < oldRoutes.size(); ++r) {
+        part.clear();
+        for (unsigned i = 0; i <= oldRoutes[r].size(); ++i) {
+            if (i < oldRoutes[r].size() && newIndex[oldRoutes[r][i]] != NO_STOP) {
+                part.push_back(newIndex[oldRoutes[r][i]]);
+                continue;
+            }
+            if (part.size() >= 2) {
+                routes.push_back(part);
+                routeServices.push_back(raptor.getRouteServices()[r]);
             }
+            part.clear();
         }
     }
-    connectWalkStop(walkingDistance);
+    raptor = Raptor(stops, routes, routeServices);
+    timetable = timetable.withoutStops(newIndex);
+    precomputeWalkEdges(walkLayerDistance);
 }
 
 /**
  * deletes connections between stops that represent a path done by foot
  */
 void Graph::clearWalkNeighbours() {
-    for (auto &node : stops) {
-        node.clearWalkNeighbours();
-    }
+    walkEdges = Adjacency(stops.size(), {});
+    walkLayerDistance = 0;
+    routeCache.clear();
 }
 
 /**
  * Constructor
  */
-Graph::Graph() {}
+Graph::Graph(): nZoneIds(0), directed(false), services(Line::ALL_SERVICES), walkingDistance(0), walkLayerDistance(0) {}
+
+/**
+ * gets the service periods of the lines taken by the searches that do not get them
+ * @return the attribute services
+ */
+unsigned char Graph::getServices() const {
+    return services;
+}
+
+/**
+ * sets the service periods of the lines taken by the searches that do not get them (like setWalkingDistance)
+ * @param services the bitmask of the services (Line::DAY_SERVICE, Line::NIGHT_SERVICE, ...)
+ */
+void Graph::setServices(unsigned char services) {
+    this->services = services;
+}
+
+/**
+ * checks if the line edges of the graph only go in the direction of travel of their line
+ * @return the attribute directed
+ */
+bool Graph::isDirected() const {
+    return directed;
+}
+
+/**
+ * gets the distance the walking edges were precomputed for
+ * @return the attribute walkLayerDistance
+ */
+double Graph::getWalkLayerDistance() const {
+    return walkLayerDistance;
+}
 
 /**
  * gets the maximum lenght of paths by foot that connect stops
@@ -22,36 +22,175 @@
 #include "algorithm"
 #include "set"
 #include <queue>
-#include "DistancePath.h"
+#include "Adjacency.h"
+#include "Snapshot.h"
+#include "SpatialGrid.h"
+#include "SearchWorkspace.h"
+#include "RouteQuery.h"
+#include "RouteCache.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "Raptor.h"
+#include "Timetable.h"
 #include <tuple>
+#include <unordered_map>
+#include <bitset>
 
 /**
  * This is the graph that stores the different bus stops
  * @param stops is the list of the bus stops on the graph
+ * @param stopIndex is the table that maps the code of a stop to its position in stops
+ * @param stopGrid is the spatial index over the coordinates of the stops (a point of the grid is the position of the stop)
+ * @param stopZones is the interned zone of every stop (read from the stops, NO_ZONE if they have none)
+ * @param nZoneIds is the number of interned zones of the stops
+ * @param lineCodes is the list of the interned line codes, the edges refer to a line by its position (0 is "walk")
+ * @param lineEdges is the adjacency of the edges made by taking a bus, built once by the constructor (every edge has the
+ * service periods of its line, so the day and the night lines share one graph)
+ * @param reverseLineEdges is the same adjacency with every edge turned around, used by the backward side of the searches
+ * @param walkEdges is the adjacency of the edges made by walking up to walkLayerDistance, sorted by distance for every stop
+ * @param landmarks is the optional table of distances to a few landmark stops that makes the bound of the A* search better
+ * @param hierarchies is the optional contraction hierarchies of the graph, each for one walking distance and services
+ * @param raptor is the round based router over the stop sequences of the lines of the graph
+ * @param timetable is the timetable of the lines that have one, with its connection scan router
+ * @param routeCache is the cache of the paths found by route, emptied whenever the stops or the edges change
+ * @param directed is true if a line edge only goes in the direction of travel of its line
+ * @param services the service periods of the lines taken by the searches that do not get them
  * @param walkingDistance the maximum distance that connects two stops by foot
+ * @param walkLayerDistance the distance the walking edges were precomputed for
  */
 class Graph {
     std::vector<Stop> stops; // The list of stops being represented
+    std::unordered_map<std::string, unsigned> stopIndex;
+    SpatialGrid stopGrid;
+    std::vector<unsigned> stopZones;
+    unsigned nZoneIds;
+    std::vector<std::string> lineCodes;
+    Adjacency lineEdges;
+    Adjacency reverseLineEdges;
+    Adjacency walkEdges;
+    Landmarks landmarks;
+    std::vector<ContractionHierarchy> hierarchies;
+    Raptor raptor;
+    Timetable timetable;
+    mutable RouteCache routeCache;
 
-    std::list<Stop> currentPath(const std::vector<DistancePath>& distPath, const Stop& start, const Stop& dest);
-    static std::list<std::tuple<double, Stop&, std::string>> combineAllNeighbours(const std::list<std::tuple<double, Stop&, std::string>>& lineNeighbours,
-                                                                           const std::list<std::tuple<double, Stop&, std::string>>& walkNeighbours);
+    /**
+     * These are the two ends of a search, a stop that is not in the graph (a coordinate chosen by the user) becomes a
+     * virtual node that only exists during that search: the source is at the index stops.size() and the target at
+     * stops.size() + 1, linked by walking to the stops around them
+     * @param source This is the index of the node where the search starts
+     * @param target This is the index of the node the search is trying to get to
+     * @param sourceLinks This is the walking edges leaving a virtual source (stop index and distance)
+     * @param targetLinks This is the walking edges reaching a virtual target, sorted by the stop index
+     * @param services This is the bitmask of the service periods of the line edges the search can take
+     */
+    struct Endpoints {
+        unsigned source;
+        unsigned target;
+        std::vector<std::pair<unsigned, double>> sourceLinks;
+        std::vector<std::pair<unsigned, double>> targetLinks;
+        unsigned char services;
+    };
+
+    static bool dominates(const SearchWorkspace::Label& a, const SearchWorkspace::Label& b);
+    template<typename Penalty>
+    std::vector<unsigned> aStarNodes(const Endpoints& endpoints, const Stop& start, const Stop& dest,
+                                     double walkingDistance, double limit, SearchWorkspace& workspace,
+                                     Penalty penalty) const;
+    Endpoints findEndpoints(const Stop& start, const Stop& dest, double walkingDistance, unsigned char services) const;
+    template<typename Visit>
+    void forEachNeighbour(unsigned node, const Endpoints& endpoints, double walkingDistance, bool backward, Visit visit) const;
+    void splitEndpoints(const Endpoints& endpoints, std::vector<std::pair<unsigned, double>>& sources,
+                        std::vector<std::pair<unsigned, double>>& targets, double& direct) const;
+    std::list<Stop> endpointsPath(const std::vector<unsigned>& nodes, const Endpoints& endpoints,
+                                  const Stop& start, const Stop& dest) const;
+    std::list<Stop> meetingPath(unsigned meeting, const Endpoints& endpoints, const SearchWorkspace& workspace,
+                                const Stop& start, const Stop& dest) const;
+    std::list<Stop> searchRoute(const RouteQuery& query, SearchWorkspace& workspace) const;
+    const ContractionHierarchy* findHierarchy(double walkingDistance, unsigned char services) const;
+    void indexStops();
+    uint64_t fingerprint() const;
+    bool directed;
+    unsigned char services;
     double walkingDistance;
+    double walkLayerDistance;
 public:
-    Graph(std::set<Stop> myStops, std::set<Line> myLines, bool isNight);
+    static const unsigned NO_STOP = std::numeric_limits<unsigned>::max();
+
+    Graph(std::set<Stop> myStops, std::set<Line> myLines, bool directed = false, unsigned nThreads = 0);
 
     Graph();
 
     void connectWalkStop(double walkingDistance);
-    std::list<Stop> dijkstra(const Stop& start, const Stop& dest, const int nLinesToChange, const int nZones);
-    std::list<Stop> BFS(const Stop& start, const Stop& dest);
+    void precomputeWalkEdges(double maxWalkingDistance, unsigned nThreads = 0);
+    std::list<Stop> dijkstra(const Stop& start, const Stop& dest, const int nLinesToChange = INT32_MAX, const int nZones = INT32_MAX) const;
+    std::list<Stop> dijkstra(const Stop& start, const Stop& dest, const int nLinesToChange, const int nZones,
+                             double walkingDistance, unsigned char services, SearchWorkspace& workspace) const;
+    std::list<Stop> BFS(const Stop& start, const Stop& dest) const;
+    std::list<Stop> BFS(const Stop& start, const Stop& dest, double walkingDistance, unsigned char services,
+                        SearchWorkspace& workspace) const;
+    std::list<Stop> aStar(const Stop& start, const Stop& dest) const;
+    std::list<Stop> aStar(const Stop& start, const Stop& dest, double walkingDistance, unsigned char services,
+                          SearchWorkspace& workspace) const;
+    std::vector<std::list<Stop>> alternativeRoutes(const Stop& start, const Stop& dest, unsigned nRoutes) const;
+    std::vector<std::list<Stop>> alternativeRoutes(const Stop& start, const Stop& dest, unsigned nRoutes,
+                                                   double walkingDistance, unsigned char services,
+                                                   SearchWorkspace& workspace) const;
+    std::list<Stop> hierarchyRoute(const Stop& start, const Stop& dest) const;
+    std::list<Stop> hierarchyRoute(const Stop& start, const Stop& dest, double walkingDistance, unsigned char services,
+                                   SearchWorkspace& workspace) const;
+    std::list<Stop> raptorRoute(const Stop& start, const Stop& dest, const int nLinesToChange = INT32_MAX) const;
+    std::list<Stop> raptorRoute(const Stop& start, const Stop& dest, const int nLinesToChange, double walkingDistance,
+                                unsigned char services, SearchWorkspace& workspace) const;
+    std::list<Stop> earliestArrival(const Stop& start, const Stop& dest, unsigned departureTime,
+                                    unsigned& arrivalTime) const;
+    std::list<Stop> earliestArrival(const Stop& start, const Stop& dest, unsigned departureTime,
+                                    double walkingDistance, unsigned char services, SearchWorkspace& workspace,
+                                    unsigned& arrivalTime) const;
+    std::vector<std::pair<unsigned, unsigned>> departureProfile(const Stop& start, const Stop& dest, unsigned earliest,
+                                                                unsigned latest) const;
+    std::vector<std::pair<unsigned, unsigned>> departureProfile(const Stop& start, const Stop& dest, unsigned earliest,
+                                                                unsigned latest, double walkingDistance,
+                                                                unsigned char services,
+                                                                SearchWorkspace& workspace) const;
+    bool hasTimetable() const;
+    std::list<Stop> bidirectionalDijkstra(const Stop& start, const Stop& dest, double walkingDistance,
+                                          unsigned char services, SearchWorkspace& workspace) const;
+    std::list<Stop> bidirectionalBFS(const Stop& start, const Stop& dest, double walkingDistance,
+                                     unsigned char services, SearchWorkspace& workspace) const;
+    void shortestPathTree(const Stop& start, double walkingDistance, unsigned char services, SearchWorkspace& workspace,
+                          bool reverse = false) const;
+    std::list<Stop> treePath(const Stop& start, unsigned node, const SearchWorkspace& workspace) const;
+    std::list<Stop> route(const RouteQuery& query, SearchWorkspace& workspace) const;
+    std::vector<std::list<Stop>> batchRoutes(const std::vector<RouteQuery>& queries, unsigned nThreads = 0) const;
+    const RouteCache& getRouteCache() const;
+    void buildLandmarks(unsigned nLandmarks, double walkingDistance, unsigned char services = Line::ALL_SERVICES,
+                        unsigned nThreads = 0);
+    bool saveLandmarks(const std::string& path) const;
+    bool loadLandmarks(const std::string& path);
+    const Landmarks &getLandmarks() const;
+    void buildContractionHierarchy(double walkingDistance, unsigned char services = Line::ALL_SERVICES);
+    bool hasContractionHierarchy(double walkingDistance, unsigned char services) const;
+    bool saveSnapshot(const std::string& path, uint64_t datasetStamp) const;
+    bool loadSnapshot(const std::string& path, uint64_t datasetStamp);
     const std::vector<Stop> &getStops() const;
+    unsigned getStopIndex(const std::string& code) const;
+    std::vector<std::pair<unsigned, double>> stopsWithinRadius(const Coordinate& center, double radius) const;
+    std::vector<std::pair<unsigned, double>> nearestStops(const Coordinate& center, unsigned k) const;
     void addStops(std::vector<Stop> newStop);
     void removeStop(std::vector<std::string> code);
     void clearWalkNeighbours();
 
+    bool isDirected() const;
+
+    unsigned char getServices() const;
+
+    void setServices(unsigned char services);
+
     double getWalkingDistance() const;
 
+    double getWalkLayerDistance() const;
+
     void setWalkingDistance(int walkingDistance);
 };
 
@@ -0,0 +1,177 @@
+/**
+ * @file Landmarks.cpp
+ * @brief This file contains the implementation of the functions in Landmarks.h (the landmark distance table)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 27/1/2022
+ */
+
+#include <fstream>
+#include <cstring>
+#include "Landmarks.h"
+
+/**
+ * This is the start of a landmark file and the version of its layout, a file with other values is not loaded
+ */
+static const char LANDMARKS_MAGIC[4] = {'A', 'L', 'T', 'B'};
+static const uint32_t LANDMARKS_VERSION = 3;
+
+/**
+ * Constructor (an empty table, the searches do not use it)
+ */
+Landmarks::Landmarks() : walkingDistance(0), services(0) {}
+
+/**
+ * Constructor
+ * @param stops This is the index of the stop of every landmark
+ * @param distancesFrom This is the distance from every landmark to every stop (stop * number of landmarks + landmark)
+ * @param distancesTo This is the distance from every stop to every landmark (stop * number of landmarks + landmark)
+ * @param walkingDistance This is the walking distance the distances were found with
+ * @param services This is the bitmask of the service periods of the lines the distances were found with
+ */
+Landmarks::Landmarks(const std::vector<unsigned> &stops, const std::vector<double> &distancesFrom,
+                     const std::vector<double> &distancesTo, double walkingDistance, unsigned char services)
+        : stops(stops), distancesFrom(distancesFrom), distancesTo(distancesTo), walkingDistance(walkingDistance),
+          services(services) {}
+
+/**
+ * This method checks if the table has landmarks
+ * @return The return is true if there are no landmarks
+ */
+bool Landmarks::empty() const {
+    return stops.empty();
+}
+
+/**
+ * This method gets the number of landmarks
+ * @return The return is the number of landmarks
+ */
+unsigned Landmarks::getNumberLandmarks() const {
+    return stops.size();
+}
+
+/**
+ * This method gets the stops chosen as landmarks
+ * @return The return is the index of the stop of every landmark
+ */
+const std::vector<unsigned> &Landmarks::getStops() const {
+    return stops;
+}
+
+/**
+ * This method gets the table of distances leaving the landmarks
+ * @return The return is the distance from every landmark to every stop (stop * number of landmarks + landmark)
+ */
+const std::vector<double> &Landmarks::getDistancesFrom() const {
+    return distancesFrom;
+}
+
+/**
+ * This method gets the table of distances reaching the landmarks
+ * @return The return is the distance from every stop to every landmark (stop * number of landmarks + landmark)
+ */
+const std::vector<double> &Landmarks::getDistancesTo() const {
+    return distancesTo;
+}
+
+/**
+ * This method gets the walking distance the table was built for
+ * @return The return is the walking distance in meters
+ */
+double Landmarks::getWalkingDistance() const {
+    return walkingDistance;
+}
+
+/**
+ * This method gets the service periods the table was built for
+ * @return The return is the bitmask of the services
+ */
+unsigned char Landmarks::getServices() const {
+    return services;
+}
+
+/**
+ * This method writes the table to a binary file
+ * @param path This is the path of the file
+ * @param fingerprint This is the fingerprint of the graph the table was built on
+ * @return The return is true if the file was written
+ */
+bool Landmarks::save(const std::string &path, uint64_t fingerprint) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    uint32_t nLandmarks = stops.size();
+    uint32_t nStops = nLandmarks == 0 ? 0 : distancesFrom.size() / nLandmarks;
+    file.write(LANDMARKS_MAGIC, sizeof(LANDMARKS_MAGIC));
+    file.write(reinterpret_cast<const char *>(&LANDMARKS_VERSION), sizeof(LANDMARKS_VERSION));
+    file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+    file.write(reinterpret_cast<const char *>(&nStops), sizeof(nStops));
+    file.write(reinterpret_cast<const char *>(&nLandmarks), sizeof(nLandmarks));
+    file.write(reinterpret_cast<const char *>(&walkingDistance), sizeof(walkingDistance));
+    file.write(reinterpret_cast<const char *>(&services), sizeof(services));
+    file.write(reinterpret_cast<const char *>(stops.data()), stops.size() * sizeof(unsigned));
+    file.write(reinterpret_cast<const char *>(distancesFrom.data()), distancesFrom.size() * sizeof(double));
+    file.write(reinterpret_cast<const char *>(distancesTo.data()), distancesTo.size() * sizeof(double));
+    return bool(file);
+}
+
+/**
+ * This method reads the table from a binary file written by save, the table is only replaced if the file is complete
+ * and was written for the same graph
+ * @param path This is the path of the file
+ * @param fingerprint This is the fingerprint of the graph the table is loaded for
+ * @param nStops This is the number of stops of the graph the table is loaded for
+ * @return The return is true if the table was loaded
+ */
+bool Landmarks::load(const std::string &path, uint64_t fingerprint, unsigned nStops) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    char magic[sizeof(LANDMARKS_MAGIC)];
+    uint32_t version, fileStops, nLandmarks;
+    uint64_t fileFingerprint;
+    double fileWalkingDistance;
+    unsigned char fileServices;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    file.read(reinterpret_cast<char *>(&fileFingerprint), sizeof(fileFingerprint));
+    file.read(reinterpret_cast<char *>(&fileStops), sizeof(fileStops));
+    file.read(reinterpret_cast<char *>(&nLandmarks), sizeof(nLandmarks));
+    file.read(reinterpret_cast<char *>(&fileWalkingDistance), sizeof(fileWalkingDistance));
+    file.read(reinterpret_cast<char *>(&fileServices), sizeof(fileServices));
+    if (!file || std::memcmp(magic, LANDMARKS_MAGIC, sizeof(magic)) != 0 || version != LANDMARKS_VERSION ||
+        fileFingerprint != fingerprint || fileStops != nStops || nLandmarks > nStops) {
+        return false;
+    }
+    //the arrays must be exactly what is left of the file, a corrupt count is refused before anything is allocated
+    std::streamoff start = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff remaining = file.tellg() - start;
+    file.seekg(start);
+    if (!file || (uint64_t) remaining != nLandmarks * (sizeof(unsigned) + 2 * sizeof(double) * (uint64_t) nStops)) {
+        return false;
+    }
+    std::vector<unsigned> fileLandmarks(nLandmarks);
+    std::vector<double> fileDistancesFrom((size_t) nStops * nLandmarks);
+    std::vector<double> fileDistancesTo((size_t) nStops * nLandmarks);
+    file.read(reinterpret_cast<char *>(fileLandmarks.data()), fileLandmarks.size() * sizeof(unsigned));
+    file.read(reinterpret_cast<char *>(fileDistancesFrom.data()), fileDistancesFrom.size() * sizeof(double));
+    file.read(reinterpret_cast<char *>(fileDistancesTo.data()), fileDistancesTo.size() * sizeof(double));
+    if (!file) {
+        return false;
+    }
+    for (unsigned stop: fileLandmarks) {
+        if (stop >= nStops) {
+            return false;
+        }
+    }
+    stops = fileLandmarks;
+    distancesFrom = fileDistancesFrom;
+    distancesTo = fileDistancesTo;
+    walkingDistance = fileWalkingDistance;
+    services = fileServices;
+    return true;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file Landmarks.h
+ * @brief This file contains the implementation of the landmark distance table used by the A* search and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 27/1/2022
+ */
+
+#ifndef AEDAGRAFOS_LANDMARKS_H
+#define AEDAGRAFOS_LANDMARKS_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/**
+ * This is the table of the shortest distances between a few chosen stops (the landmarks) and every stop of a graph, in
+ * both directions since the line edges of a directed graph only go one way. By the triangle inequality d(L,t) - d(L,v)
+ * and d(v,L) - d(t,L) are never longer than the distance from v to t, which the A* search uses as a bound. The table
+ * is only valid for the graph it was built on, so it can be saved to a file with a fingerprint of that graph and is
+ * refused when loaded for a different one
+ * @param stops This is the index of the stop of every landmark
+ * @param distancesFrom This is the distance in meters from every landmark to every stop, the ones of the same stop are
+ * stored together (stop * number of landmarks + landmark), INT32_MAX if the stop can not be reached
+ * @param distancesTo This is the distance in meters from every stop to every landmark, stored like distancesFrom
+ * @param walkingDistance This is the walking distance the table was built for, it is a valid bound for the searches
+ * that walk up to this distance (they use less edges, so their paths are never shorter)
+ * @param services This is the bitmask of the service periods the table was built for, for the same reason it is a valid
+ * bound for the searches that only take lines of some of these services
+ */
+class Landmarks {
+public:
+    Landmarks();
+
+    Landmarks(const std::vector<unsigned> &stops, const std::vector<double> &distancesFrom,
+              const std::vector<double> &distancesTo, double walkingDistance, unsigned char services);
+
+    bool empty() const;
+
+    unsigned getNumberLandmarks() const;
+
+    const std::vector<unsigned> &getStops() const;
+
+    const std::vector<double> &getDistancesFrom() const;
+
+    const std::vector<double> &getDistancesTo() const;
+
+    double getWalkingDistance() const;
+
+    unsigned char getServices() const;
+
+    bool save(const std::string &path, uint64_t fingerprint) const;
+
+    bool load(const std::string &path, uint64_t fingerprint, unsigned nStops);
+
+private:
+    std::vector<unsigned> stops;
+    std::vector<double> distancesFrom;
+    std::vector<double> distancesTo;
+    double walkingDistance;
+    unsigned char services;
+};
+
+
+#endif //AEDAGRAFOS_LANDMARKS_H
@@ -0,0 +1,81 @@
+/**
+ * @file LandmarksTest.cpp
+ * @brief This file contains the regression checks of the landmark bounds of the A* search
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <iostream>
+#include <cmath>
+#include "Graph.h"
+
+/**
+ * This is the number of meters in a degree of latitude (and of longitude on the equator), used to place the stops
+ */
+static const double METERS_PER_DEGREE = 6371000 * M_PI / 180.0;
+
+/**
+ * This method makes a place some meters away from the origin of the checks (on the equator, where a degree of
+ * longitude and of latitude have the same length)
+ * @param code This is the code of the place
+ * @param east This is the distance to the east in meters
+ * @param north This is the distance to the north in meters
+ * @return The return is the place
+ */
+static Stop place(const std::string &code, double east, double north) {
+    return Stop(code, code, "Z1", Coordinate(north / METERS_PER_DEGREE, east / METERS_PER_DEGREE));
+}
+
+/**
+ * This method gets the length of a path
+ * @param path This is the path
+ * @return The return is the sum of the distances between its stops
+ */
+static double length(const std::list<Stop> &path) {
+    double total = 0;
+    const Stop *previous = nullptr;
+    for (const auto &stop: path) {
+        if (previous != nullptr) {
+            total += previous->distance(stop);
+        }
+        previous = &stop;
+    }
+    return total;
+}
+
+/**
+ * This checks the bound of a destination that is not a stop when a stop linked to it can not reach a landmark: the
+ * origin walks to Q or P, the destination is between the dead end T1 (reached from Q) and T2 (reached from P, and
+ * then going on to the landmarks). The shortest route is Q -> T1, and the landmarks must not make A* go through P
+ * @return The return is true if A* finds the same length as Dijkstra
+ */
+static bool deadEndTargetLink() {
+    std::set<Stop> stops = {place("Q", 0, 50), place("P", 0, -80), place("T1", 1500, 90), place("T2", 1500, -90),
+                            place("X", 3000, -90), place("Y", 1500, 2000)};
+    std::set<Line> lines = {Line({"Q", "T1"}, "L1", "L1", 0), Line({"P", "T2", "X"}, "L2", "L2", 0),
+                            Line({"Q", "Y", "X"}, "L3", "L3", 0)};
+    Graph graph(stops, lines, true, 1);
+    graph.precomputeWalkEdges(100, 1);
+    graph.buildLandmarks(6, 100, Line::ALL_SERVICES, 1);
+
+    Stop origin("ORIGIN", place("O", 0, 0).getCoordinate());
+    Stop destination("DESTINATION", place("D", 1500, 0).getCoordinate());
+    SearchWorkspace workspace;
+    double expected = length(graph.dijkstra(origin, destination, INT32_MAX, INT32_MAX, 100, Line::ALL_SERVICES,
+                                            workspace));
+    double found = length(graph.aStar(origin, destination, 100, Line::ALL_SERVICES, workspace));
+    if (std::fabs(expected - found) > 1e-6) {
+        std::cout << "deadEndTargetLink: A* found " << found << " m, the shortest route is " << expected << " m"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    bool passed = deadEndTargetLink();
+    std::cout << (passed ? "All landmark checks passed" : "Some landmark checks failed") << std::endl;
+    return passed ? 0 : 1;
+}
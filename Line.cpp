@@ -9,22 +9,28 @@
 
 #include "Line.h"
 
+const unsigned char Line::DAY_SERVICE;
+const unsigned char Line::NIGHT_SERVICE;
+const unsigned char Line::ALL_SERVICES;
+
 /**
  * Constructor
  * @param stops This is the stops to be added to the new bus line
  * @param code This is the code of the bus line
  * @param name This is the name of the bus line
  * @param direction This is the direction the bus line is going to
+ * (the line runs in the day service until setServices says otherwise)
  */
 Line::Line(const std::vector<std::string> stops, const std::string &code, const std::string &name, int direction) : stops(stops),
                                                                                                  code(code),
                                                                                                  name(name),
-                                                                                                 direction(direction){}
+                                                                                                 direction(direction),
+                                                                                                 services(DAY_SERVICE){}
 
 /**
  * Constructor
  */
-Line::Line() {}
+Line::Line() : direction(0), services(0) {}
 
 /**
  * This function is used to get the code of a bus line
@@ -34,6 +40,47 @@ const std::string &Line::getCode() const {
     return code;
 }
 
+/**
+ * This function is used to get the direction of a bus line
+ * @return The return is the direction (0 or 1)
+ */
+int Line::getDirection() const {
+    return direction;
+}
+
+/**
+ * This function is used to get the service periods of a bus line
+ * @return The return is the bitmask of the services the line runs in (DAY_SERVICE, NIGHT_SERVICE, ...)
+ */
+unsigned char Line::getServices() const {
+    return services;
+}
+
+/**
+ * This function is used to set the service periods of a bus line
+ * @param services This is the bitmask of the services the line runs in
+ */
+void Line::setServices(unsigned char services) {
+    this->services = services;
+}
+
+/**
+ * This function is used to get the timetable of a bus line
+ * @return The return is the times every trip leaves every stop of the line (in seconds after midnight)
+ */
+const std::vector<std::vector<unsigned>> &Line::getTrips() const {
+    return trips;
+}
+
+/**
+ * This function is used to add a trip to the timetable of a bus line
+ * @param times This is the time the bus leaves every stop of the line, in the order of the stops (in seconds after
+ * midnight, not decreasing)
+ */
+void Line::addTrip(const std::vector<unsigned> &times) {
+    trips.push_back(times);
+}
+
 /**
  * This function is used to get the stops of a bus line
  * @return The return is a vector with the stops of the bus line
@@ -61,36 +108,37 @@ std::ostream &operator<<(std::ostream &os, const Line &line) {
 }
 
 /**
- * operator to compare two Lines by their code
+ * operator to compare two Lines by their code and then by their direction (the two directions of a line are different
+ * Lines)
  * @param rhs the Line
- * @return if the *this' code is lesser in alphabetic order
+ * @return if the *this' code is lesser in alphabetic order, or the same code with a lesser direction
  */
 bool Line::operator<(const Line &rhs) const {
-    return code < rhs.code;
+    return code < rhs.code || (code == rhs.code && direction < rhs.direction);
 }
 
 /**
- * operator to compare two Lines by their code
+ * operator to compare two Lines by their code and direction
  * @param rhs the Line
- * @return if the *this' code is greater in alphabetic order
+ * @return if the *this' line comes after rhs (code, then direction)
  */
 bool Line::operator>(const Line &rhs) const {
     return rhs < *this;
 }
 
 /**
- * operator to compare two Lines by their code
+ * operator to compare two Lines by their code and direction
  * @param rhs the Line
- * @return if the *this' code is lesser or equal in alphabetic order
+ * @return if the *this' line does not come after rhs (code, then direction)
  */
 bool Line::operator<=(const Line &rhs) const {
     return !(rhs < *this);
 }
 
 /**
- * operator to compare two Lines by their code
+ * operator to compare two Lines by their code and direction
  * @param rhs the Line
- * @return if the *this' code is greater or equal in alphabetic order
+ * @return if the *this' line does not come before rhs (code, then direction)
  */
 bool Line::operator>=(const Line &rhs) const {
     return !(*this < rhs);
@@ -21,9 +21,20 @@
  * @param name This is the name of the bus line
  * @param stops This is a vector with all the bus stops on the bus line
  * @param direction This is used to indicate the direction of the bus line
+ * @param services This is the bitmask of the service periods the bus line runs in
+ * @param trips This is the timetable of the bus line, for every trip the time (in seconds after the midnight of the day
+ * of service) its bus leaves every stop (empty if the line has no timetable)
  */
 class Line {
 public:
+    /**
+     * These are the bits of the service periods of a line, a search only takes the lines that run in one of the
+     * periods it asks for (every bit set asks for all of them)
+     */
+    static const unsigned char DAY_SERVICE = 1;
+    static const unsigned char NIGHT_SERVICE = 2;
+    static const unsigned char ALL_SERVICES = 0xFF;
+
     Line(const std::vector<std::string> stops, const std::string &code, const std::string &name, int direction);
 
     Line();
@@ -42,11 +53,23 @@ public:
 
     const std::string &getCode() const;
 
+    int getDirection() const;
+
+    unsigned char getServices() const;
+
+    void setServices(unsigned char services);
+
+    const std::vector<std::vector<unsigned>> &getTrips() const;
+
+    void addTrip(const std::vector<unsigned> &times);
+
 private:
     std::vector<std::string> stops;
     std::string code;
     std::string name;
     int direction;
+    unsigned char services;
+    std::vector<std::vector<unsigned>> trips;
 };
 
 
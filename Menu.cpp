@@ -10,6 +10,40 @@
 
 #include "Menu.h"
 
+/**
+ * This function writes a time of the day as HH:MM
+ * @param seconds This is the time in seconds after midnight
+ * @return The return is the time written
+ */
+static std::string formatTime(unsigned seconds) {
+    unsigned minutes = (seconds + 59) / 60;
+    std::string minute = std::to_string(minutes % 60);
+    return std::to_string(minutes / 60) + ":" + (minute.size() < 2 ? "0" : "") + minute;
+}
+
+/**
+ * This function moves a place chosen by coordinates to the nearest stop when no stop is within the walking distance
+ * of it (the search would not find a route from there), and tells the user
+ * @param map This is the graph
+ * @param place This is the place (a stop or a coordinate)
+ * @param walkingDistance This is the maximum distance to walk
+ * @return The return is the nearest stop, or the place if it is a stop or has a stop close enough
+ */
+static Stop snapToStop(const Graph &map, const Stop &place, double walkingDistance) {
+    if (map.getStopIndex(place.getCode()) != Graph::NO_STOP ||
+        !map.stopsWithinRadius(place.getCoordinate(), walkingDistance).empty()) {
+        return place;
+    }
+    std::vector<std::pair<unsigned, double>> nearest = map.nearestStops(place.getCoordinate(), 1);
+    if (nearest.empty()) {
+        return place;
+    }
+    const Stop &stop = map.getStops()[nearest.front().first];
+    std::cout << "There is no stop within " << walkingDistance << " m of the " << place.getCode()
+              << ", searching from the nearest stop " << stop.getCode() << " (" << (long) nearest.front().second
+              << " m away)" << std::endl;
+    return stop;
+}
 
 /**
  * This function controls the display and flow of the menu, it outputs to the screen and asks player for the input (redirect
@@ -58,7 +92,6 @@ void Menu::display()  {
                 else if (choice == 1) {
                     Coordinate coord = displayCoord();
                     database.partida = Stop("ORIGIN", coord);
-                    database.mapDay.addStops({database.partida});
                 }
                 else if (choice == 2) {
                     Stop code = displayCode();
@@ -88,7 +121,6 @@ void Menu::display()  {
                 else if (choice == 1) {
                     Coordinate coord = displayCoord();
                     database.chegada = Stop("DESTINATION",coord);
-                    database.mapDay.addStops({database.chegada});
                 }
                 else if (choice == 2) {
                     Stop code = displayCode();
@@ -113,31 +145,51 @@ void Menu::display()  {
                 double dist;
                 cin >> dist;
                 std::cout << "Introduce the maximum amount of " << std::endl
-                          << "line changes you would allow:" << std::endl;
+                          << "line changes you would allow (-1 for no limit):" << std::endl;
                 int lineChanges;
                 cin >> lineChanges;
+                if (lineChanges < 0) lineChanges = INT32_MAX;
                 std::cout << "Introduce the maximum number of zones" << std::endl
-                          << "you would want to pass:" << std::endl;
+                          << "you would want to pass (-1 for no limit):" << std::endl;
                 int zones;
                 cin >> zones;
+                if (zones < 0) zones = INT32_MAX;
+                //the earliest arrival is only asked for if some line has a timetable
+                int maxChoice;
+                maxChoice = database.map.hasTimetable() ? 3 : 2;
                 std::cout << "What's your preference?" << std::endl
                           << "(Please choose an option)" << std::endl << std::endl
                           << "1. Lesser distance" << std::endl
-                          << "2. Lesser number of stops" << std::endl
-                          << "0. Back to main menu" << std::endl;
+                          << "2. Lesser number of stops" << std::endl;
+                if (maxChoice == 3) {
+                    std::cout << "3. Earliest arrival" << std::endl;
+                }
+                std::cout << "0. Back to main menu" << std::endl;
                 choice = -1; //set it to invalid
                 do {
                     choice = getInt();
-                    if (choice < 0 || choice > 2) {
+                    if (choice < 0 || choice > maxChoice) {
                         std::cout << "Please choose a valid option!" << std::endl << std::endl << "1. Lesser distance"
-                                  << std::endl << "2. Lesser number of stops" << std::endl << "0. Back to main menu" << std::endl;
+                                  << std::endl << "2. Lesser number of stops" << std::endl;
+                        if (maxChoice == 3) {
+                            std::cout << "3. Earliest arrival" << std::endl;
+                        }
+                        std::cout << "0. Back to main menu" << std::endl;
                     }
-                } while (choice < 0 || choice > 2);
+                } while (choice < 0 || choice > maxChoice);
                 if (choice == 0) {
                     menuPage = 0;
                     break;
                 }
                 else{
+                    if (choice == 3) {
+                        std::cout << "Introduce the time you leave (HH:MM):" << std::endl;
+                        std::string time = getString();
+                        while (!CsvReader::Field{time.data(), time.size()}.toTime(database.departureTime)) {
+                            std::cout << "Invalid!" << std::endl;
+                            time = getString();
+                        }
+                    }
 
                     if (timeSearch == 1) {database.dayShift = true;}
                     else {database.dayShift = false;}
@@ -198,7 +250,7 @@ Stop Menu::displayCode() const {
     while (true) {
         std::cout << "Enter the stop code:";
         string code = getString();
-        for (auto a: database.mapDay.getStops()) {
+        for (auto a: database.map.getStops()) {
             if (a.getCode() == code)
                 return a;
         }
@@ -208,35 +260,37 @@ Stop Menu::displayCode() const {
 
 /**
  * This function is called after all the information about the the search is collected and the starting place and destination
- * place is set. It calls the search using BFS or Dijkstra (depending on the user choice) and display the route resultant
- * from the search if found any or a message saying a route was not found.
+ * place is set. It calls the search using BFS, the contraction hierarchy, A*, the round based router, Dijkstra or the
+ * connection scan over the timetable (depending on the user choice and on the limits of the lesser distance) and display the route resultant from the search if found any or a message saying a route was not found.
  */
 void Menu::displayResults() {
 
     std::cout << "Searching for routes... Please wait" << std::endl;
 
-    database.mapDay.connectWalkStop(database.maxwalk);
+    //the origin and destination coordinates are linked to the graph only during the search, the graph is not changed
+    Graph& map = database.map;
+    map.connectWalkStop(database.maxwalk);
+    map.setServices(database.dayShift ? Line::DAY_SERVICE : Line::NIGHT_SERVICE);
+
+    Stop start = snapToStop(map, database.partida, database.maxwalk);
+    Stop dest = snapToStop(map, database.chegada, database.maxwalk);
 
     list<Stop> result;
-    switch (database.searchtype) {
-        case 1:
-            if(database.dayShift)
-                result = database.mapDay.dijkstra(database.partida, database.chegada, database.maxlines, database.maxzones);
-            else
-                result = database.mapNight.dijkstra(database.partida, database.chegada, database.maxlines, database.maxzones);
-            break;
-        case 2:
-            if(database.dayShift)
-                result = database.mapDay.BFS(database.partida, database.chegada);
-            else
-                result = database.mapNight.BFS(database.partida, database.chegada);
-            break;
-        default:
-            if(database.dayShift)
-                result = database.mapDay.dijkstra(database.partida, database.chegada, database.maxlines, database.maxzones);
-            else
-                result = database.mapNight.dijkstra(database.partida, database.chegada, database.maxlines, database.maxzones);
-            break;
+    unsigned arrivalTime = Timetable::NO_TIME;
+    if (database.searchtype == 3) {
+        result = map.earliestArrival(start, dest, database.departureTime, arrivalTime);
+    }
+    else {
+        //the graph picks the search for the limits, and a request asked again is answered by its route cache
+        RouteQuery query;
+        query.start = start;
+        query.dest = dest;
+        query.searchType = database.searchtype == 2 ? RouteQuery::LEAST_STOPS : RouteQuery::SHORTEST_DISTANCE;
+        query.nLinesToChange = database.maxlines;
+        query.nZones = database.maxzones;
+        query.walkingDistance = database.maxwalk;
+        query.services = map.getServices();
+        result = map.route(query, workspace);
     }
 
     if(result.empty()){
@@ -245,17 +299,18 @@ void Menu::displayResults() {
     else {
         std::cout << "This is the best route based on your specification:" << std::endl;
         for (const auto& stop: result) {
-            if(stop == database.chegada) {
+            if(stop == dest) {
                 std::cout << stop.getCode() << std::endl;
             }
             else{
                 std::cout << stop.getCode() << " -> ";
             }
         }
+        if (arrivalTime != Timetable::NO_TIME) {
+            std::cout << "Leaving at " << formatTime(database.departureTime) << ", you arrive at "
+                      << formatTime(arrivalTime) << std::endl;
+        }
     }
-
-    database.mapDay.removeStop({"ORIGIN","DESTINATION"});
-
 }
 
 /**
@@ -26,6 +26,7 @@ class Menu {
 public:
 
     Database database;
+    SearchWorkspace workspace; //the memory of the route searches, reused by every search
 
     static int getInt();
     static double getDouble();
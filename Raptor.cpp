@@ -0,0 +1,324 @@
+/**
+ * @file Raptor.cpp
+ * @brief This file contains the implementation of the functions in Raptor.h (the round based router)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 28/1/2022
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include "Raptor.h"
+
+const unsigned Raptor::NO_ROUTE;
+
+/**
+ * This is the value of a distance that was not found
+ */
+static const double UNREACHED = INT32_MAX;
+
+/**
+ * Constructor (a router without routes)
+ */
+Raptor::Raptor() : routeOffsets(1, 0), stopOffsets(1, 0) {}
+
+/**
+ * Constructor, it lays out the routes one after the other and builds the list of the routes of every stop
+ * @param stops This is the stops of the graph (the distance between two consecutive stops of a route is the straight
+ * line between them, like the edges of the graph)
+ * @param routes This is the index of the stops of every route, in the order the bus goes through them
+ * @param routeServices This is the bitmask of the service periods every route runs in
+ */
+Raptor::Raptor(const std::vector<Stop> &stops, const std::vector<std::vector<unsigned>> &routes,
+               const std::vector<unsigned char> &routeServices) : routeOffsets(1, 0), routeServices(routeServices) {
+    for (const auto &route: routes) {
+        for (unsigned i = 0; i < route.size(); ++i) {
+            routeStops.push_back(route[i]);
+            routeDistances.push_back(i == 0 ? 0 : routeDistances.back() + stops[route[i]].distance(stops[route[i - 1]]));
+        }
+        routeOffsets.push_back(routeStops.size());
+    }
+
+    //counting sort of the positions of the routes by their stop
+    stopOffsets.assign(stops.size() + 1, 0);
+    for (unsigned stop: routeStops) {
+        stopOffsets[stop + 1]++;
+    }
+    for (unsigned i = 0; i < stops.size(); ++i) {
+        stopOffsets[i + 1] += stopOffsets[i];
+    }
+    stopRoutes.resize(routeStops.size());
+    std::vector<unsigned> next(stopOffsets.begin(), stopOffsets.end() - 1);
+    for (unsigned route = 0; route + 1 < routeOffsets.size(); ++route) {
+        for (unsigned p = routeOffsets[route]; p < routeOffsets[route + 1]; ++p) {
+            stopRoutes[next[routeStops[p]]++] = {route, p - routeOffsets[route]};
+        }
+    }
+}
+
+/**
+ * This method gets the number of routes
+ * @return The return is the number of routes
+ */
+unsigned Raptor::getNumberRoutes() const {
+    return routeOffsets.size() - 1;
+}
+
+/**
+ * This method expands the routes back into lists of stops, it is used when the router needs to be rebuilt
+ * @return The return is the index of the stops of every route
+ */
+std::vector<std::vector<unsigned>> Raptor::getRoutes() const {
+    std::vector<std::vector<unsigned>> routes;
+    for (unsigned route = 0; route + 1 < routeOffsets.size(); ++route) {
+        routes.emplace_back(routeStops.begin() + routeOffsets[route], routeStops.begin() + routeOffsets[route + 1]);
+    }
+    return routes;
+}
+
+/**
+ * This method gets the service periods of the routes, it is used with getRoutes when the router needs to be rebuilt
+ * @return The return is the bitmask of the services of every route
+ */
+const std::vector<unsigned char> &Raptor::getRouteServices() const {
+    return routeServices;
+}
+
+/**
+ * This method writes the routes to a snapshot (the rest of the router is rebuilt from them when it is read)
+ * @param snapshot This is the snapshot being written
+ */
+void Raptor::save(Snapshot &snapshot) const {
+    snapshot.putArray(routeOffsets);
+    snapshot.putArray(routeStops);
+    snapshot.putArray(routeServices);
+}
+
+/**
+ * This method reads the routes from a snapshot written by save and rebuilds the router, it is only replaced if the
+ * routes are complete and only go through the stops given
+ * @param snapshot This is the mapped snapshot
+ * @param stops This is the stops of the graph
+ * @return The return is true if the router was read
+ */
+bool Raptor::load(Snapshot &snapshot, const std::vector<Stop> &stops) {
+    std::vector<unsigned> offsets, sequence;
+    std::vector<unsigned char> services;
+    if (!snapshot.getArray(offsets) || !snapshot.getArray(sequence) || !snapshot.getArray(services) ||
+        offsets.empty() || offsets.front() != 0 || offsets.back() != sequence.size() ||
+        services.size() + 1 != offsets.size()) {
+        return false;
+    }
+    std::vector<std::vector<unsigned>> routes;
+    for (unsigned route = 0; route + 1 < offsets.size(); ++route) {
+        if (offsets[route] > offsets[route + 1]) {
+            return false;
+        }
+        routes.emplace_back(sequence.begin() + offsets[route], sequence.begin() + offsets[route + 1]);
+    }
+    for (unsigned stop: sequence) {
+        if (stop >= stops.size()) {
+            return false;
+        }
+    }
+    *this = Raptor(stops, routes, services);
+    return true;
+}
+
+/**
+ * This method finds the shortest path between a set of sources and a set of targets taking at most a number of buses,
+ * every source and target has an extra distance (the walk from a place that is not a stop)
+ * @param sources This is the stops where the path may start and the distance to get to them
+ * @param targets This is the stops where the path may end and the distance from them to the destination
+ * @param maxBoardings This is the maximum number of buses that can be taken
+ * @param services This is the bitmask of the service periods of the routes that can be taken
+ * @param walkEdges This is the walking edges between the stops, sorted by distance for every stop
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @param workspace This is the memory the search works on
+ * @param path This is where the stops of the path are stored, empty if there is no path
+ * @return The return is the distance of the path in meters, INT32_MAX if there is no path
+ */
+double Raptor::route(const std::vector<std::pair<unsigned, double>> &sources,
+                     const std::vector<std::pair<unsigned, double>> &targets, unsigned maxBoardings,
+                     unsigned char services, const Adjacency &walkEdges, double walkingDistance,
+                     SearchWorkspace &workspace, std::vector<unsigned> &path) const {
+    path.clear();
+    unsigned nStops = stopOffsets.size() - 1;
+    unsigned nRoutes = routeOffsets.size() - 1;
+    if (workspace.marked.size() < nStops) {
+        workspace.marked.resize(nStops, false);
+    }
+    if (workspace.routeStart.size() < nRoutes) {
+        workspace.routeStart.resize(nRoutes, NO_ROUTE);
+    }
+    std::vector<char> &marked = workspace.marked;
+    std::vector<unsigned> &markedStops = workspace.markedStops;
+    auto mark = [&](unsigned stop) {
+        if (!marked[stop]) {
+            marked[stop] = true;
+            markedStops.push_back(stop);
+        }
+    };
+
+    //round 0 is the sources and the stops that can be reached from them by walking
+    const SearchWorkspace::RoundStep none = {NO_ROUTE, NO_ROUTE, NO_ROUTE, 0, 0};
+    workspace.roundDistance.resize(1);
+    workspace.roundSteps.resize(1);
+    workspace.roundDistance[0].assign(nStops, UNREACHED);
+    workspace.roundSteps[0].assign(nStops, none);
+    for (const auto &source: sources) {
+        if (source.second < workspace.roundDistance[0][source.first]) {
+            workspace.roundDistance[0][source.first] = source.second;
+            mark(source.first);
+        }
+    }
+
+    double bestTarget = UNREACHED;
+    unsigned bestRound = 0, bestStop = NO_ROUTE;
+    auto checkTargets = [&](unsigned round) {
+        for (const auto &target: targets) {
+            double distance = workspace.roundDistance[round][target.first] + target.second;
+            if (distance < bestTarget) {
+                bestTarget = distance;
+                bestRound = round;
+                bestStop = target.first;
+            }
+        }
+    };
+    walk(0, walkEdges, walkingDistance, bestTarget, workspace);
+    checkTargets(0);
+
+    for (unsigned round = 1; round <= maxBoardings && !markedStops.empty(); ++round) {
+        //every route is scanned from the first stop of it that was improved in the round before
+        for (unsigned stop: markedStops) {
+            for (unsigned i = stopOffsets[stop]; i < stopOffsets[stop + 1]; ++i) {
+                unsigned route = stopRoutes[i].first;
+                if (!(routeServices[route] & services)) {
+                    continue;
+                }
+                if (workspace.routeStart[route] == NO_ROUTE) {
+                    workspace.queuedRoutes.push_back(route);
+                    workspace.routeStart[route] = stopRoutes[i].second;
+                }
+                else {
+                    workspace.routeStart[route] = std::min(workspace.routeStart[route], stopRoutes[i].second);
+                }
+            }
+            marked[stop] = false;
+        }
+        markedStops.clear();
+
+        workspace.roundDistance.resize(round + 1);
+        workspace.roundSteps.resize(round + 1);
+        workspace.roundDistance[round] = workspace.roundDistance[round - 1];
+        workspace.roundSteps[round] = workspace.roundSteps[round - 1];
+        const std::vector<double> &before = workspace.roundDistance[round - 1];
+        std::vector<double> &current = workspace.roundDistance[round];
+        std::vector<SearchWorkspace::RoundStep> &steps = workspace.roundSteps[round];
+
+        for (unsigned route: workspace.queuedRoutes) {
+            unsigned first = routeOffsets[route];
+            unsigned length = routeOffsets[route + 1] - first;
+            //the best stop to take the bus at so far, by its distance minus the distance along the route
+            double boardValue = UNREACHED;
+            unsigned boardPosition = 0;
+            for (unsigned position = workspace.routeStart[route]; position < length; ++position) {
+                unsigned stop = routeStops[first + position];
+                double along = routeDistances[first + position];
+                if (boardValue < UNREACHED) {
+                    double arrival = boardValue + along;
+                    if (arrival < current[stop] && arrival < bestTarget) {
+                        current[stop] = arrival;
+                        steps[stop] = {routeStops[first + boardPosition], round - 1, route, boardPosition, position};
+                        mark(stop);
+                    }
+                }
+                if (before[stop] < UNREACHED && before[stop] - along < boardValue) {
+                    boardValue = before[stop] - along;
+                    boardPosition = position;
+                }
+            }
+            workspace.routeStart[route] = NO_ROUTE;
+        }
+        workspace.queuedRoutes.clear();
+
+        walk(round, walkEdges, walkingDistance, bestTarget, workspace);
+        checkTargets(round);
+    }
+    for (unsigned stop: markedStops) {
+        marked[stop] = false;
+    }
+    markedStops.clear();
+
+    if (bestStop == NO_ROUTE) {
+        return UNREACHED;
+    }
+    //follow the steps back to a source
+    unsigned round = bestRound, stop = bestStop;
+    path.push_back(stop);
+    while (workspace.roundSteps[round][stop].previous != NO_ROUTE) {
+        const SearchWorkspace::RoundStep &step = workspace.roundSteps[round][stop];
+        if (step.route == NO_ROUTE) {
+            path.push_back(step.previous);
+        }
+        else {
+            for (unsigned position = step.position; position-- > step.boardPosition;) {
+                path.push_back(routeStops[routeOffsets[step.route] + position]);
+            }
+        }
+        stop = step.previous;
+        round = step.round;
+    }
+    std::reverse(path.begin(), path.end());
+    return bestTarget;
+}
+
+/**
+ * This method follows the walking edges from the stops improved in a round (a dijkstra search over the walking edges
+ * only, so a walk can go through many stops), the stops improved by walking are also marked
+ * @param round This is the round
+ * @param walkEdges This is the walking edges between the stops, sorted by distance for every stop
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @param bound This is the distance of the best path to a target found so far, longer paths are not followed
+ * @param workspace This is the memory the search works on
+ */
+void Raptor::walk(unsigned round, const Adjacency &walkEdges, double walkingDistance, double bound,
+                  SearchWorkspace &workspace) const {
+    std::vector<double> &current = workspace.roundDistance[round];
+    std::vector<SearchWorkspace::RoundStep> &steps = workspace.roundSteps[round];
+    std::vector<std::pair<double, unsigned>> &stopsToVisit = workspace.heap;
+    std::greater<std::pair<double, unsigned>> heapOrder;
+    const std::vector<unsigned> &offsets = walkEdges.getOffsets();
+    const std::vector<unsigned> &walkTargets = walkEdges.getTargets();
+    const std::vector<double> &weights = walkEdges.getWeights();
+
+    stopsToVisit.clear();
+    for (unsigned stop: workspace.markedStops) {
+        stopsToVisit.push_back({current[stop], stop});
+    }
+    std::make_heap(stopsToVisit.begin(), stopsToVisit.end(), heapOrder);
+    while (!stopsToVisit.empty()) {
+        std::pop_heap(stopsToVisit.begin(), stopsToVisit.end(), heapOrder);
+        std::pair<double, unsigned> top = stopsToVisit.back();
+        stopsToVisit.pop_back();
+        unsigned stop = top.second;
+        if (top.first > current[stop]) {
+            continue;
+        }
+        for (unsigned e = offsets[stop]; e < offsets[stop + 1] && weights[e] <= walkingDistance; ++e) {
+            unsigned neighbour = walkTargets[e];
+            double distance = current[stop] + weights[e];
+            if (distance < current[neighbour] && distance < bound) {
+                current[neighbour] = distance;
+                steps[neighbour] = {stop, round, NO_ROUTE, 0, 0};
+                if (!workspace.marked[neighbour]) {
+                    workspace.marked[neighbour] = true;
+                    workspace.markedStops.push_back(neighbour);
+                }
+                stopsToVisit.push_back({distance, neighbour});
+                std::push_heap(stopsToVisit.begin(), stopsToVisit.end(), heapOrder);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/**
+ * @file Raptor.h
+ * @brief This file contains the implementation of the round based router over the bus lines and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 28/1/2022
+ */
+
+#ifndef AEDAGRAFOS_RAPTOR_H
+#define AEDAGRAFOS_RAPTOR_H
+
+#include <vector>
+#include <utility>
+#include "Stop.h"
+#include "Adjacency.h"
+#include "SearchWorkspace.h"
+
+/**
+ * This is a round based router (RAPTOR) that works directly on the stop sequences of the lines. The round k finds the
+ * shortest distance to every stop taking at most k buses: every line (route) that goes through a stop improved by the
+ * round before is scanned once from that stop to its end, and then the walking edges of the stops improved by the
+ * scan are followed. Taking a bus is a linear scan of the route instead of heap operations, and the number of buses is
+ * exact because it is the round
+ * @param routeOffsets This is the position in routeStops of the first stop of every route
+ * @param routeStops This is the stops of every route, in the order the bus goes through them
+ * @param routeDistances This is the distance along the route from its first stop to every stop of it
+ * @param stopOffsets This is the position in stopRoutes of the first route of every stop
+ * @param stopRoutes This is the routes (and the position in them) that go through every stop
+ * @param routeServices This is the bitmask of the service periods every route runs in
+ */
+class Raptor {
+public:
+    static const unsigned NO_ROUTE = 0xFFFFFFFF;
+
+    Raptor();
+
+    Raptor(const std::vector<Stop> &stops, const std::vector<std::vector<unsigned>> &routes,
+           const std::vector<unsigned char> &routeServices);
+
+    unsigned getNumberRoutes() const;
+
+    std::vector<std::vector<unsigned>> getRoutes() const;
+
+    const std::vector<unsigned char> &getRouteServices() const;
+
+    void save(Snapshot &snapshot) const;
+
+    bool load(Snapshot &snapshot, const std::vector<Stop> &stops);
+
+    double route(const std::vector<std::pair<unsigned, double>> &sources,
+                 const std::vector<std::pair<unsigned, double>> &targets, unsigned maxBoardings,
+                 unsigned char services, const Adjacency &walkEdges, double walkingDistance,
+                 SearchWorkspace &workspace, std::vector<unsigned> &path) const;
+
+private:
+    std::vector<unsigned> routeOffsets;
+    std::vector<unsigned> routeStops;
+    std::vector<double> routeDistances;
+    std::vector<unsigned> stopOffsets;
+    std::vector<std::pair<unsigned, unsigned>> stopRoutes;
+    std::vector<unsigned char> routeServices;
+
+    void walk(unsigned round, const Adjacency &walkEdges, double walkingDistance, double bound,
+              SearchWorkspace &workspace) const;
+};
+
+
+#endif //AEDAGRAFOS_RAPTOR_H
@@ -0,0 +1,122 @@
+/**
+ * @file RaptorTest.cpp
+ * @brief This file contains the regression checks of the round based router against the dijkstra search
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <iostream>
+#include <cmath>
+#include "Graph.h"
+
+/**
+ * This is the number of meters in a degree of latitude (and of longitude on the equator), used to place the stops
+ */
+static const double METERS_PER_DEGREE = 6371000 * M_PI / 180.0;
+
+/**
+ * These are the limits of lines to change the searches are compared with (INT32_MAX is no limit)
+ */
+static const int LINE_LIMITS[] = {0, 1, 2, 3, 5, INT32_MAX};
+
+/**
+ * This method makes a stop some meters away from the origin of the checks (on the equator, where a degree of
+ * longitude and of latitude have the same length)
+ * @param code This is the code of the stop
+ * @param east This is the distance to the east in meters
+ * @param north This is the distance to the north in meters
+ * @return The return is the stop
+ */
+static Stop place(const std::string &code, double east, double north) {
+    return Stop(code, code, "Z1", Coordinate(north / METERS_PER_DEGREE, east / METERS_PER_DEGREE));
+}
+
+/**
+ * This method gets the length of a path
+ * @param path This is the path
+ * @return The return is the sum of the distances between its stops, -1 if there is no path
+ */
+static double length(const std::list<Stop> &path) {
+    if (path.empty()) {
+        return -1;
+    }
+    double total = 0;
+    const Stop *previous = nullptr;
+    for (const auto &stop: path) {
+        if (previous != nullptr) {
+            total += previous->distance(stop);
+        }
+        previous = &stop;
+    }
+    return total;
+}
+
+/**
+ * This method compares the round based router with the dijkstra search between every pair of stops of a graph, for
+ * every limit of lines to change
+ * @param name This is the name of the check, written when it fails
+ * @param graph This is the graph
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @return The return is true if both searches found routes of the same length (or both found none)
+ */
+static bool sameAsDijkstra(const std::string &name, const Graph &graph, double walkingDistance) {
+    SearchWorkspace workspace;
+    bool passed = true;
+    for (const auto &start: graph.getStops()) {
+        for (const auto &dest: graph.getStops()) {
+            for (int limit: LINE_LIMITS) {
+                double expected = length(graph.dijkstra(start, dest, limit, INT32_MAX, walkingDistance,
+                                                        Line::ALL_SERVICES, workspace));
+                double found = length(graph.raptorRoute(start, dest, limit, walkingDistance, Line::ALL_SERVICES,
+                                                        workspace));
+                if (std::fabs(expected - found) > 1e-6) {
+                    std::cout << name << ": " << start.getCode() << " -> " << dest.getCode() << " changing at most "
+                              << limit << " lines, RAPTOR found " << found << " m, dijkstra " << expected << " m"
+                              << std::endl;
+                    passed = false;
+                }
+            }
+        }
+    }
+    return passed;
+}
+
+/**
+ * This checks a graph that is not directed: the bus of the line A -> B -> C can be taken from C to A, so a limit of
+ * lines does not turn the route into no route
+ * @return The return is true if RAPTOR finds the same routes as dijkstra
+ */
+static bool undirectedLine() {
+    std::set<Stop> stops = {place("A", 0, 0), place("B", 1000, 0), place("C", 2000, 0)};
+    std::set<Line> lines = {Line({"A", "B", "C"}, "L1", "L1", 0)};
+    Graph graph(stops, lines, false, 1);
+    return sameAsDijkstra("undirectedLine", graph, 0);
+}
+
+/**
+ * This checks a small network with changes of line and a walk between two stops, in both modes of the graph
+ * @return The return is true if RAPTOR finds the same routes as dijkstra
+ */
+static bool transfers() {
+    std::set<Stop> stops = {place("A", 0, 0), place("B", 1000, 0), place("C", 2000, 0), place("D", 3000, 0),
+                            place("E", 1000, -1000), place("F", 1000, 1000), place("G", 2000, 1000),
+                            place("H", 2080, 1000), place("I", 3000, 1000)};
+    std::set<Line> lines = {Line({"A", "B", "C", "D"}, "L1", "L1", 0), Line({"E", "B", "F"}, "L2", "L2", 0),
+                            Line({"F", "G", "D"}, "L3", "L3", 0), Line({"H", "I", "D"}, "L4", "L4", 0)};
+    bool passed = true;
+    for (bool directed: {false, true}) {
+        Graph graph(stops, lines, directed, 1);
+        graph.precomputeWalkEdges(100, 1);
+        passed &= sameAsDijkstra(directed ? "transfers (directed)" : "transfers", graph, 100);
+    }
+    return passed;
+}
+
+int main() {
+    bool passed = undirectedLine();
+    passed &= transfers();
+    std::cout << (passed ? "All RAPTOR checks passed" : "Some RAPTOR checks failed") << std::endl;
+    return passed ? 0 : 1;
+}
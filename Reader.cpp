@@ -7,120 +7,255 @@
  * @date 20/1/2022
  */
 
+#include <thread>
+#include <atomic>
+#include <sys/stat.h>
 #include "Reader.h"
 
 /**
- * This methods reads and organize the information about the bus stops
+ * This methods reads and organize the information about the bus stops, the zones are interned to small numbers in the
+ * order they first appear so the searches can handle them as sets of bits. The file is read at once and parsed in
+ * place, a malformed row is reported with its line number and skipped
  * @param filename This is the file to read
  * @return This returns a set of the stops the function read
  */
-std::set<Stop> Reader::readStops(std::string filename) {
+std::set<Stop> Reader::readStops(const std::string& filename) {
     std::set<Stop> myStops;
-    std::ifstream my_file;
-    my_file.open(filename, std::ios::in);
-    if (!my_file) {
-        std::cout << "File not exists!";
-    }
-    else {
-        Stop myStop;
-        std::string code;
-        std::string name;
-        std::string zone;
-        std::string latitude;
-        std::string longitude;
-
-        std::string header;
-        std::getline (my_file,header, ',');
-        std::getline (my_file,header, ',');
-        std::getline (my_file,header, ',');
-        std::getline (my_file,header, ',');
-        std::getline (my_file,header, '\n');
-
-        while(!my_file.eof()){
-
-            std::getline(my_file,code, ',');
-            std::getline (my_file,name, ',');
-            std::getline (my_file,zone, ',');
-            std::getline (my_file,latitude, ',');
-            std::getline (my_file,longitude, '\n');
-
-            myStop = Stop(code,name, zone, Coordinate(std::stod(latitude), std::stod(longitude)));
-            myStops.insert(myStop);
+    CsvReader csv;
+    if (!csv.open(filename)) {
+        std::cout << "File not exists! " << filename << std::endl;
+        return myStops;
+    }
+    std::unordered_map<std::string, unsigned> zoneIds;
+    std::string zone;
+    csv.nextRow(); //the header
+    while (csv.nextRow()) {
+        const std::vector<CsvReader::Field>& fields = csv.getFields();
+        if (fields.size() != 5) {
+            csv.report("expected 5 fields (code, name, zone, latitude, longitude), found " + std::to_string(fields.size()));
+            continue;
+        }
+        double latitude, longitude;
+        if (!fields[3].toDouble(latitude) || !fields[4].toDouble(longitude)) {
+            csv.report("invalid coordinates of stop " + fields[0].toString());
+            continue;
         }
+        zone.assign(fields[2].data, fields[2].size);
+        Stop myStop(fields[0].toString(), fields[1].toString(), zone, Coordinate(latitude, longitude));
+        myStop.setZoneId(zoneIds.insert({zone, zoneIds.size()}).first->second);
+        myStops.insert(myStop);
     }
     return myStops;
 }
 
 /**
- * This methods reads and organize the information about the bus lines
+ * This methods reads and organize the information about the bus lines, the stop codes of the line files are looked up
+ * in a hash index of the stops. The line files are shared by a pool of threads, every file is read into its own slot
+ * and the slots are merged in the order of the list, so the result is the same as reading them one after another.
+ * The timetable of a line, if it has one, is next to its file (dataset/timetable_<code>_<direction>.csv)
  * @param filename This is the file to read
+ * @param stops This is the stops the lines go through
+ * @param nThreads This is the number of threads to use, 0 uses one for every core
  * @return This returns a set of the lines the function read
  */
-std::set<Line> Reader::readLines(std::string filename, std::set<Stop> stops) {
+std::set<Line> Reader::readLines(const std::string& filename, const std::set<Stop>& stops, unsigned nThreads) {
     std::set<Line> myLines;
-    std::ifstream my_file;
-
-    my_file.open(filename, std::ios::in);
-    if (!my_file) {
-        std::cout << "File not exists!";
-    }
-    else {
-        Stop stop;
-        std::string code;
-        std::string name;
-        std::string stopCode;
-        std::ifstream my_fileLine;
-        std::string filenameLine;
-        Line line;
-        std::getline (my_file,code, ',');
-        std::getline (my_file,name, '\n');
-        while(!my_file.eof()) {
-            std::getline (my_file,code, ',');
-            std::getline (my_file,name, '\n');
-            for (int i = 0; i < 2; ++i) {
-                filenameLine = "dataset/line_" + code + "_" + std::to_string(i) + ".csv";
-                line = readLine(stops, filenameLine, code, name, i);
-                myLines.insert(line);
+    CsvReader csv;
+    if (!csv.open(filename)) {
+        std::cout << "File not exists! " << filename << std::endl;
+        return myLines;
+    }
+    std::unordered_set<std::string> stopCodes;
+    stopCodes.reserve(stops.size());
+    for (const auto& stop: stops) {
+        stopCodes.insert(stop.getCode());
+    }
+    //in pair, first the code and after the name of every line of the list
+    std::vector<std::pair<std::string, std::string>> codes;
+    csv.nextRow(); //the header
+    while (csv.nextRow()) {
+        if (csv.getFields().size() < 2) {
+            csv.report("expected 2 fields (code, name), found " + std::to_string(csv.getFields().size()));
+            continue;
+        }
+        codes.emplace_back(csv.getFields()[0].toString(), csv.getRest(1).toString()); //a name may have commas
+    }
 
+    //every line has a file for each direction, every thread takes the next file that no one took yet
+    std::vector<Line> read(2 * codes.size());
+    if (nThreads == 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<size_t>(nThreads, std::max<size_t>(1, read.size()));
+    std::atomic<size_t> nextFile(0);
+    auto worker = [&]() {
+        std::vector<bool> known;
+        for (size_t i = nextFile++; i < read.size(); i = nextFile++) {
+            const auto& line = codes[i / 2];
+            int direction = i % 2;
+            std::string filenameLine = "dataset/line_" + line.first + "_" + std::to_string(direction) + ".csv";
+            read[i] = readLine(stopCodes, filenameLine, line.first, line.second, direction, known);
+            if (!read[i].getCode().empty()) {
+                readTimetable("dataset/timetable_" + line.first + "_" + std::to_string(direction) + ".csv", read[i],
+                              known);
             }
         }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < nThreads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    for (auto& line: read) {
+        myLines.insert(std::move(line));
     }
     return myLines;
 }
 
 /**
- * This function is used to read the lines for the files that contains the different bus lines
- * @param stops This is the set of stops in the bus line
+ * This function is used to read the lines for the files that contains the different bus lines, the first row is the
+ * number of stops and every other row is the code of a stop. A row with an unknown stop is reported with its line
+ * number and skipped
+ * @param stopCodes This is the index of the codes of the stops that exist
  * @param filename This is the file to read
  * @param code This is the code of the bus line
  * @param name This is the name of the bus line
  * @param direction This is the direction the bus line is going to
- * @return The return is a line with the information read added to it
+ * @param known This is where it is stored, for every row of stops of the file, if it is a stop of the line (false for
+ * a row that was skipped), so the columns of the timetable can be matched to the stops
+ * @return The return is a line with the information read added to it, in the night service if its code ends in M
+ * and in the day service otherwise (a line without code if the file could not be read)
  */
-Line Reader::readLine(std::set<Stop> stops, std::string filename,
-                      std::string code, std::string name, int direction){
-    Stop stop;
-    int nStops;
-    std::string strNStops;
+Line Reader::readLine(const std::unordered_set<std::string>& stopCodes, const std::string& filename,
+                      const std::string& code, const std::string& name, int direction, std::vector<bool>& known){
+    known.clear();
+    CsvReader csv;
+    if (!csv.open(filename)) {
+        std::cout << "File not exists! " + filename + "\n"; //one write, the files are read by many threads
+        return Line();
+    }
+    unsigned long nStops;
+    if (!csv.nextRow() || csv.getFields().size() != 1 || !csv.getFields()[0].toUnsigned(nStops)) {
+        csv.report("expected the number of stops");
+        return Line();
+    }
     std::vector<std::string> stopsCodeLine;
+    stopsCodeLine.reserve(nStops);
     std::string stopCode;
-    std::ifstream my_fileLine;
-    my_fileLine.open(filename, std::ios::in);
-    if (!my_fileLine) {
-        std::cout << "File not exists!";
-        return Line();
+    unsigned long nRows = 0;
+    while (nRows < nStops && csv.nextRow()) {
+        nRows++;
+        const CsvReader::Field& field = csv.getFields()[0];
+        stopCode.assign(field.data, field.size);
+        if (csv.getFields().size() != 1 || stopCodes.find(stopCode) == stopCodes.end()) {
+            csv.report("unknown stop " + csv.getRest(0).toString());
+            known.push_back(false);
+            continue;
+        }
+        known.push_back(true);
+        stopsCodeLine.push_back(stopCode);
+    }
+    if (nRows < nStops) {
+        csv.report("expected " + std::to_string(nStops) + " stops, found " + std::to_string(nRows));
     }
-    else {
-        std::getline(my_fileLine,strNStops, '\n');
-        nStops = std::stoi(strNStops);
-        stopsCodeLine = {};
-        for (int j = 0; j < nStops; ++j) {
-            getline(my_fileLine, stopCode, '\n');
-            stop = *std::find(stops.begin(), stops.end(), stopCode);
-            stopsCodeLine.push_back(stop.getCode());
+
+    Line line(stopsCodeLine, code, name, direction);
+    //the night lines are the ones whose code ends in M
+    line.setServices(!code.empty() && code.back() == 'M' ? Line::NIGHT_SERVICE : Line::DAY_SERVICE);
+    return line;
+}
+
+/**
+ * This function is used to read the timetable of a bus line, the first row names the columns and every other row is a
+ * trip with the time its bus leaves every stop of the line file (H:MM or H:MM:SS, in the order of the rows of the
+ * file, so the stops that readLine skipped have a column too and their times are dropped). A trip with another number
+ * of times or with a time before the one of the stop before is reported with its line number and skipped. A line
+ * without a timetable file just has no trips
+ * @param filename This is the file to read
+ * @param line This is the line the trips are added to
+ * @param known This is, for every row of stops of the line file, if it is a stop of the line (given by readLine)
+ * @return The return is true if the file was read
+ */
+bool Reader::readTimetable(const std::string& filename, Line& line, const std::vector<bool>& known) {
+    CsvReader csv;
+    if (!csv.open(filename)) {
+        return false;
+    }
+    std::vector<unsigned> times;
+    csv.nextRow(); //the header
+    while (csv.nextRow()) {
+        const std::vector<CsvReader::Field>& fields = csv.getFields();
+        if (fields.size() != known.size()) {
+            csv.report("expected " + std::to_string(known.size()) + " times, found " + std::to_string(fields.size()));
+            continue;
+        }
+        times.clear();
+        unsigned last = 0;
+        size_t column = 0;
+        for (; column < fields.size(); ++column) {
+            unsigned time;
+            if (!fields[column].toTime(time) || time < last) {
+                csv.report("invalid time " + fields[column].toString());
+                break;
+            }
+            last = time;
+            if (known[column]) {
+                times.push_back(time);
+            }
+        }
+        if (column == fields.size()) {
+            line.addTrip(times);
         }
-        my_fileLine.close();
     }
+    return true;
+}
 
-    return Line(stopsCodeLine, code, name, direction);
+/**
+ * This method calculates a stamp of the files of the dataset, made from the size and the time of the last change of
+ * the list of stops, the list of lines and the files of every line and of their timetables (a file that does not exist
+ * counts too). A snapshot of the network keeps the stamp of the files it was built from, so it is not loaded after
+ * one of them changed (FNV-1a hash)
+ * @param stopsFile This is the file of the stops
+ * @param linesFile This is the file of the list of lines
+ * @return The return is the stamp
+ */
+uint64_t Reader::datasetStamp(const std::string& stopsFile, const std::string& linesFile) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    auto addFile = [&](const std::string& filename) {
+        struct stat status;
+        int64_t values[2] = {-1, -1};
+        if (stat(filename.c_str(), &status) == 0) {
+            values[0] = status.st_size;
+            values[1] = status.st_mtime;
+        }
+        add(filename.c_str(), filename.size() + 1);
+        add(values, sizeof(values));
+    };
+    addFile(stopsFile);
+    addFile(linesFile);
+    CsvReader csv;
+    if (!csv.open(linesFile)) {
+        return hash;
+    }
+    csv.nextRow(); //the header
+    while (csv.nextRow()) {
+        if (csv.getFields().empty()) {
+            continue;
+        }
+        std::string code = csv.getFields()[0].toString();
+        for (int direction = 0; direction < 2; ++direction) {
+            addFile("dataset/line_" + code + "_" + std::to_string(direction) + ".csv");
+            addFile("dataset/timetable_" + code + "_" + std::to_string(direction) + ".csv");
+        }
+    }
+    return hash;
 }
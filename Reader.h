@@ -21,16 +21,22 @@
 #include "Coordinate.h"
 #include "set"
 #include "algorithm"
+#include <unordered_map>
+#include <unordered_set>
+#include "CsvReader.h"
+#include <cstdint>
 
 /**
  * This class is the reader with its methods to ble able to read the files
  */
 class Reader {
 public:
-    static std::set<Stop> readStops(std::string filename);
-    static std::set<Line> readLines(std::string filename, std::set<Stop> stops);
-    static Line readLine(std::set<Stop> stops, std::string filename,
-                          std::string code, std::string name, int direction);
+    static std::set<Stop> readStops(const std::string& filename);
+    static std::set<Line> readLines(const std::string& filename, const std::set<Stop>& stops, unsigned nThreads = 0);
+    static Line readLine(const std::unordered_set<std::string>& stopCodes, const std::string& filename,
+                         const std::string& code, const std::string& name, int direction, std::vector<bool>& known);
+    static bool readTimetable(const std::string& filename, Line& line, const std::vector<bool>& known);
+    static uint64_t datasetStamp(const std::string& stopsFile, const std::string& linesFile);
 
 };
 
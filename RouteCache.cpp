@@ -0,0 +1,178 @@
+/**
+ * @file RouteCache.cpp
+ * @brief This file contains the implementation of the functions in RouteCache.h
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <functional>
+#include "RouteCache.h"
+
+const size_t RouteCache::DEFAULT_CAPACITY;
+
+/**
+ * This method mixes a value into a hash
+ * @param seed This is the hash so far
+ * @param value This is the hash of the value
+ */
+static void combineHash(size_t &seed, size_t value) {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+/**
+ * This method gets the hash of a request
+ * @param query This is the request
+ * @return The return is the hash of its endpoints, preference, limits, walking distance and services
+ */
+size_t RouteCache::QueryHash::operator()(const RouteQuery &query) const {
+    size_t seed = std::hash<std::string>()(query.start.getCode());
+    combineHash(seed, std::hash<std::string>()(query.dest.getCode()));
+    combineHash(seed, std::hash<double>()(query.start.getCoordinate().getLat()));
+    combineHash(seed, std::hash<double>()(query.start.getCoordinate().getLon()));
+    combineHash(seed, std::hash<double>()(query.dest.getCoordinate().getLat()));
+    combineHash(seed, std::hash<double>()(query.dest.getCoordinate().getLon()));
+    combineHash(seed, std::hash<int>()(query.searchType));
+    combineHash(seed, std::hash<int>()(query.nLinesToChange));
+    combineHash(seed, std::hash<int>()(query.nZones));
+    combineHash(seed, std::hash<double>()(query.walkingDistance));
+    combineHash(seed, query.services);
+    return seed;
+}
+
+/**
+ * This method compares two requests, the endpoints are compared by code and coordinates because the places chosen by
+ * the user all have the same code
+ * @param a This is the first request
+ * @param b This is the second request
+ * @return The return is true if they are the same request
+ */
+bool RouteCache::QueryEqual::operator()(const RouteQuery &a, const RouteQuery &b) const {
+    return a.start.getCode() == b.start.getCode() && a.dest.getCode() == b.dest.getCode() &&
+           a.start.getCoordinate().getLat() == b.start.getCoordinate().getLat() &&
+           a.start.getCoordinate().getLon() == b.start.getCoordinate().getLon() &&
+           a.dest.getCoordinate().getLat() == b.dest.getCoordinate().getLat() &&
+           a.dest.getCoordinate().getLon() == b.dest.getCoordinate().getLon() &&
+           a.searchType == b.searchType && a.nLinesToChange == b.nLinesToChange && a.nZones == b.nZones &&
+           a.walkingDistance == b.walkingDistance && a.services == b.services;
+}
+
+/**
+ * Constructor (an empty cache)
+ * @param capacity This is the maximum number of paths kept (0 keeps none)
+ */
+RouteCache::RouteCache(size_t capacity) : capacity(capacity), hits(0), misses(0) {}
+
+/**
+ * Copy constructor, the copy is an empty cache with the same capacity (the paths belong to the graph they were found on)
+ * @param other This is the cache copied
+ */
+RouteCache::RouteCache(const RouteCache &other) : capacity(other.getCapacity()), hits(0), misses(0) {}
+
+/**
+ * Assignment, the cache is emptied and takes the capacity of the other one (like the copy constructor)
+ * @param other This is the cache copied
+ * @return The return is this cache
+ */
+RouteCache &RouteCache::operator=(const RouteCache &other) {
+    if (this != &other) {
+        size_t otherCapacity = other.getCapacity();
+        std::lock_guard<std::mutex> lock(mutex);
+        capacity = otherCapacity;
+        entries.clear();
+        positions.clear();
+        hits = 0;
+        misses = 0;
+    }
+    return *this;
+}
+
+/**
+ * This method looks for the path of a request, a path found becomes the most recently used
+ * @param query This is the request
+ * @param path This is where the path is copied to if it is found
+ * @return The return is true if the request is in the cache
+ */
+bool RouteCache::find(const RouteQuery &query, std::list<Stop> &path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto position = positions.find(query);
+    if (position == positions.end()) {
+        misses++;
+        return false;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, position->second);
+    path = position->second->second;
+    return true;
+}
+
+/**
+ * This method keeps the path of a request (an empty path, no route, is kept too), forgetting the least recently used
+ * path if the cache is full
+ * @param query This is the request
+ * @param path This is the path found for it
+ */
+void RouteCache::insert(const RouteQuery &query, const std::list<Stop> &path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (capacity == 0) {
+        return;
+    }
+    auto position = positions.find(query);
+    if (position != positions.end()) {
+        //another thread searched the same request at the same time
+        entries.splice(entries.begin(), entries, position->second);
+        return;
+    }
+    if (entries.size() >= capacity) {
+        positions.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(query, path);
+    positions[query] = entries.begin();
+}
+
+/**
+ * This method forgets every path (the counters are kept)
+ */
+void RouteCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    positions.clear();
+}
+
+/**
+ * gets the maximum number of paths kept
+ * @return the attribute capacity
+ */
+size_t RouteCache::getCapacity() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return capacity;
+}
+
+/**
+ * gets the number of paths kept
+ * @return the number of entries
+ */
+size_t RouteCache::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+/**
+ * gets the number of requests that were found
+ * @return the attribute hits
+ */
+uint64_t RouteCache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+/**
+ * gets the number of requests that were not found
+ * @return the attribute misses
+ */
+uint64_t RouteCache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file RouteCache.h
+ * @brief This file contains the implementation of the cache of the routes already searched and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#ifndef AEDAGRAFOS_ROUTECACHE_H
+#define AEDAGRAFOS_ROUTECACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+#include "Stop.h"
+#include "RouteQuery.h"
+
+/**
+ * This is a cache of the paths found for the last route requests, so a request that is asked again (like the ones
+ * between the busiest stops) gets its path without searching the graph. It keeps at most capacity paths and forgets the
+ * least recently used one when it is full. A request is the same as another if it has the same endpoints (code and
+ * coordinates), preference, limits, walking distance and services. Many threads can use it at the same time, every
+ * method takes the lock. The owner clears it when the graph changes
+ * @param capacity This is the maximum number of paths kept
+ * @param entries This is the requests and their paths, from the most recently used to the least
+ * @param positions This is the table that maps a request to its position in entries
+ * @param hits This is the number of requests that were found
+ * @param misses This is the number of requests that were not found
+ * @param mutex This is the lock of the cache
+ */
+class RouteCache {
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    explicit RouteCache(size_t capacity = DEFAULT_CAPACITY);
+
+    RouteCache(const RouteCache &other);
+
+    RouteCache &operator=(const RouteCache &other);
+
+    bool find(const RouteQuery &query, std::list<Stop> &path);
+
+    void insert(const RouteQuery &query, const std::list<Stop> &path);
+
+    void clear();
+
+    size_t getCapacity() const;
+
+    size_t getSize() const;
+
+    uint64_t getHits() const;
+
+    uint64_t getMisses() const;
+
+private:
+    /**
+     * This is the hash of a request, made from the same fields that are compared by QueryEqual
+     */
+    struct QueryHash {
+        size_t operator()(const RouteQuery &query) const;
+    };
+
+    /**
+     * This tells if two requests are the same request
+     */
+    struct QueryEqual {
+        bool operator()(const RouteQuery &a, const RouteQuery &b) const;
+    };
+
+    typedef std::list<std::pair<RouteQuery, std::list<Stop>>> Entries;
+
+    size_t capacity;
+    Entries entries;
+    std::unordered_map<RouteQuery, Entries::iterator, QueryHash, QueryEqual> positions;
+    uint64_t hits;
+    uint64_t misses;
+    mutable std::mutex mutex;
+};
+
+
+#endif //AEDAGRAFOS_ROUTECACHE_H
@@ -0,0 +1,41 @@
+/**
+ * @file RouteQuery.h
+ * @brief This file contains a route search request, the information needed to search one route on the graph
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 24/1/2022
+ */
+
+#ifndef AEDAGRAFOS_ROUTEQUERY_H
+#define AEDAGRAFOS_ROUTEQUERY_H
+
+#include <cstdint>
+#include "Stop.h"
+#include "Line.h"
+
+/**
+ * This is a request to search one route on the graph
+ * @param start This is the place (stop or coordinate) where the route starts
+ * @param dest This is the place (stop or coordinate) where the route ends
+ * @param searchType This is the preference of the user: SHORTEST_DISTANCE or LEAST_STOPS
+ * @param nLinesToChange This is the maximum number of lines change allowed (INT32_MAX for no limit)
+ * @param nZones This is the maximum number of zones allowed (INT32_MAX for no limit)
+ * @param walkingDistance This is the maximum distance in meters the user is open to walk between stops
+ * @param services This is the bitmask of the service periods of the lines the route can take
+ */
+struct RouteQuery {
+    static const int SHORTEST_DISTANCE = 1;
+    static const int LEAST_STOPS = 2;
+
+    Stop start;
+    Stop dest;
+    int searchType = SHORTEST_DISTANCE;
+    int nLinesToChange = INT32_MAX;
+    int nZones = INT32_MAX;
+    double walkingDistance = 0;
+    unsigned char services = Line::ALL_SERVICES;
+};
+
+
+#endif //AEDAGRAFOS_ROUTEQUERY_H
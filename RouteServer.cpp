@@ -0,0 +1,937 @@
+/**
+ * @file RouteServer.cpp
+ * @brief This file contains the implementation of the functions in RouteServer.h
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <cctype>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include "RouteServer.h"
+
+/**
+ * This is the number of bytes read from a connection at a time
+ */
+static const size_t READ_BUFFER_SIZE = 65536;
+
+/**
+ * This is the longest request line accepted, a connection that sends a longer one is closed
+ */
+static const size_t MAX_REQUEST_SIZE = 65536;
+
+/**
+ * These are the limits of a connection that sends requests faster than it reads the answers: the most requests it can
+ * have waiting for their answer to be written, and the most bytes of answers not written yet. While one of them is
+ * reached the connection is not read, so its requests wait in the socket instead of the memory of the server
+ */
+static const uint64_t MAX_PENDING_REQUESTS = 256;
+static const size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+/**
+ * This is the walking distance in meters of a request that does not have one
+ */
+static const double DEFAULT_WALKING_DISTANCE = 100;
+
+/**
+ * This is the most routes a request can ask for with "alternatives"
+ */
+static const unsigned MAX_ALTERNATIVES = 5;
+
+/**
+ * These tell the event loop that the process was interrupted (SIGINT or SIGTERM), the handler writes to the pipe of the
+ * running server so the loop wakes up
+ */
+static volatile sig_atomic_t interrupted = 0;
+static int interruptPipe = -1;
+
+/**
+ * This is a value of a request: a string, a number, true/false or null
+ * @param type This is 's' for a string, 'n' for a number, 'b' for true/false and '0' for null
+ * @param text This is the string (without the quotes and the escapes)
+ * @param number This is the number (1 for true and 0 for false)
+ * @param raw This is the value as it was written in the request
+ */
+struct JsonValue {
+    char type;
+    std::string text;
+    double number;
+    std::string raw;
+};
+
+/**
+ * This method is the handler of SIGINT and SIGTERM while a server runs
+ * @param signal This is the signal
+ */
+static void onInterrupt(int signal) {
+    (void) signal;
+    interrupted = 1;
+    if (interruptPipe >= 0) {
+        char byte = 0;
+        ssize_t written = write(interruptPipe, &byte, 1);
+        (void) written;
+    }
+}
+
+/**
+ * This method makes a file descriptor non blocking
+ * @param fd This is the file descriptor
+ * @return The return is false if it could not be changed
+ */
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * This method skips the spaces of a request
+ * @param text This is the request
+ * @param position This is the position, moved to the first character that is not a space
+ */
+static void skipSpaces(const std::string &text, size_t &position) {
+    while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\r' ||
+                                      text[position] == '\n')) {
+        position++;
+    }
+}
+
+/**
+ * This method reads a JSON string (the escapes \uXXXX are written as UTF-8)
+ * @param text This is the request
+ * @param position This is the position of the opening quote, moved past the closing one
+ * @param value This is where the string is stored
+ * @return The return is false if it is not a valid string
+ */
+static bool parseJsonString(const std::string &text, size_t &position, std::string &value) {
+    if (position >= text.size() || text[position] != '"') {
+        return false;
+    }
+    value.clear();
+    for (++position; position < text.size(); ++position) {
+        char current = text[position];
+        if (current == '"') {
+            ++position;
+            return true;
+        }
+        if ((unsigned char) current < 0x20) {
+            return false;
+        }
+        if (current != '\\') {
+            value += current;
+            continue;
+        }
+        if (++position >= text.size()) {
+            return false;
+        }
+        switch (text[position]) {
+            case '"': value += '"'; break;
+            case '\\': value += '\\'; break;
+            case '/': value += '/'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                if (position + 4 >= text.size()) {
+                    return false;
+                }
+                unsigned code = 0;
+                for (unsigned i = 1; i <= 4; ++i) {
+                    char digit = text[position + i];
+                    code <<= 4;
+                    if (digit >= '0' && digit <= '9') code |= digit - '0';
+                    else if (digit >= 'a' && digit <= 'f') code |= digit - 'a' + 10;
+                    else if (digit >= 'A' && digit <= 'F') code |= digit - 'A' + 10;
+                    else return false;
+                }
+                position += 4;
+                if (code < 0x80) {
+                    value += (char) code;
+                } else if (code < 0x800) {
+                    value += (char) (0xC0 | (code >> 6));
+                    value += (char) (0x80 | (code & 0x3F));
+                } else {
+                    value += (char) (0xE0 | (code >> 12));
+                    value += (char) (0x80 | ((code >> 6) & 0x3F));
+                    value += (char) (0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return false;
+}
+
+/**
+ * This method checks that a number is written the way JSON writes numbers: an optional minus, then 0 or digits that do
+ * not start with 0, then optional decimals and an optional exponent (so "+1", ".5" and "1." are not numbers). The
+ * value of "id" is written back as it was in the request, so it must be valid JSON
+ * @param number This is the number as it was written
+ * @return The return is true if it is a JSON number
+ */
+static bool isJsonNumber(const std::string &number) {
+    size_t position = 0;
+    auto digits = [&]() {
+        size_t start = position;
+        while (position < number.size() && std::isdigit((unsigned char) number[position])) {
+            position++;
+        }
+        return position > start;
+    };
+    if (position < number.size() && number[position] == '-') {
+        position++;
+    }
+    if (position < number.size() && number[position] == '0') {
+        position++;
+    } else if (!digits()) {
+        return false;
+    }
+    if (position < number.size() && number[position] == '.') {
+        position++;
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (position < number.size() && (number[position] == 'e' || number[position] == 'E')) {
+        position++;
+        if (position < number.size() && (number[position] == '+' || number[position] == '-')) {
+            position++;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+    return position == number.size();
+}
+
+/**
+ * This method reads a request, a JSON object whose values are strings, numbers, true/false or null (the requests have
+ * no nested objects or arrays)
+ * @param text This is the request
+ * @param values This is where the values are stored, by their key
+ * @param error This is where the problem is described if the request is not valid
+ * @return The return is false if the request is not valid
+ */
+static bool parseJsonObject(const std::string &text, std::unordered_map<std::string, JsonValue> &values,
+                            std::string &error) {
+    size_t position = 0;
+    skipSpaces(text, position);
+    if (position >= text.size() || text[position] != '{') {
+        error = "the request is not a JSON object";
+        return false;
+    }
+    ++position;
+    skipSpaces(text, position);
+    bool first = true;
+    while (position < text.size() && text[position] != '}') {
+        if (!first) {
+            if (text[position] != ',') {
+                error = "expected a comma";
+                return false;
+            }
+            ++position;
+            skipSpaces(text, position);
+        }
+        first = false;
+        std::string key;
+        if (!parseJsonString(text, position, key)) {
+            error = "expected a key";
+            return false;
+        }
+        skipSpaces(text, position);
+        if (position >= text.size() || text[position] != ':') {
+            error = "expected a colon after \"" + key + "\"";
+            return false;
+        }
+        ++position;
+        skipSpaces(text, position);
+
+        JsonValue value = {'0', "", 0, ""};
+        size_t start = position;
+        if (position < text.size() && text[position] == '"') {
+            value.type = 's';
+            if (!parseJsonString(text, position, value.text)) {
+                error = "the value of \"" + key + "\" is not a valid string";
+                return false;
+            }
+        } else if (text.compare(position, 4, "true") == 0 || text.compare(position, 5, "false") == 0) {
+            value.type = 'b';
+            value.number = text[position] == 't';
+            position += text[position] == 't' ? 4 : 5;
+        } else if (text.compare(position, 4, "null") == 0) {
+            position += 4;
+        } else {
+            while (position < text.size() && (std::isdigit((unsigned char) text[position]) || text[position] == '-' ||
+                                              text[position] == '+' || text[position] == '.' ||
+                                              text[position] == 'e' || text[position] == 'E')) {
+                position++;
+            }
+            std::string number = text.substr(start, position - start);
+            if (!isJsonNumber(number)) {
+                error = "the value of \"" + key + "\" is not a string, a number, true, false or null";
+                return false;
+            }
+            value.type = 'n';
+            value.number = std::strtod(number.c_str(), nullptr);
+        }
+        value.raw = text.substr(start, position - start);
+        values[key] = value;
+        skipSpaces(text, position);
+    }
+    if (position >= text.size()) {
+        error = "the object is not closed";
+        return false;
+    }
+    ++position;
+    skipSpaces(text, position);
+    if (position != text.size()) {
+        error = "there is more after the object";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * This method writes a string as a JSON string
+ * @param text This is the string
+ * @return The return is the string between quotes, with the quotes, the backslashes and the control characters escaped
+ */
+static std::string jsonString(const std::string &text) {
+    std::string result = "\"";
+    for (char current: text) {
+        if (current == '"' || current == '\\') {
+            result += '\\';
+            result += current;
+        } else if ((unsigned char) current < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned) current);
+            result += escaped;
+        } else {
+            result += current;
+        }
+    }
+    return result + "\"";
+}
+
+/**
+ * This method gets a limit of a request (a whole number that is not negative)
+ * @param values This is the values of the request
+ * @param key This is the key of the limit
+ * @param limit This is where the limit is stored, it is not changed if the request does not have it
+ * @param error This is where the problem is described if the value is not valid
+ * @return The return is false if the value is not valid
+ */
+static bool getLimit(const std::unordered_map<std::string, JsonValue> &values, const std::string &key, int &limit,
+                     std::string &error) {
+    auto value = values.find(key);
+    if (value == values.end() || value->second.type == '0') {
+        return true;
+    }
+    double number = value->second.number;
+    if (value->second.type != 'n' || number < 0 || number != std::floor(number)) {
+        error = "\"" + key + "\" must be a whole number that is not negative";
+        return false;
+    }
+    limit = number >= INT32_MAX ? INT32_MAX : (int) number;
+    return true;
+}
+
+/**
+ * This method gets an end of the route of a request: the code of a stop ("from") or a coordinate ("fromLat" and
+ * "fromLon")
+ * @param graph This is the graph the stop is looked for in
+ * @param values This is the values of the request
+ * @param key This is the key of the end ("from" or "to")
+ * @param placeCode This is the code given to a coordinate (like the menu does)
+ * @param place This is where the end is stored
+ * @param error This is where the problem is described if the end is not valid
+ * @return The return is false if the end is not valid
+ */
+static bool getPlace(const Graph &graph, const std::unordered_map<std::string, JsonValue> &values,
+                     const std::string &key, const std::string &placeCode, Stop &place, std::string &error) {
+    auto code = values.find(key);
+    if (code != values.end() && code->second.type == 's') {
+        unsigned index = graph.getStopIndex(code->second.text);
+        if (index == Graph::NO_STOP) {
+            error = "there is no stop " + code->second.text;
+            return false;
+        }
+        place = graph.getStops()[index];
+        return true;
+    }
+    auto lat = values.find(key + "Lat"), lon = values.find(key + "Lon");
+    if (lat != values.end() && lon != values.end() && lat->second.type == 'n' && lon->second.type == 'n') {
+        //a number too big for a double is read as infinity, neither can be placed on the grid of the stops
+        double latitude = lat->second.number, longitude = lon->second.number;
+        if (!std::isfinite(latitude) || !std::isfinite(longitude) || latitude < -90 || latitude > 90 ||
+            longitude < -180 || longitude > 180) {
+            error = "\"" + key + "Lat\" must be from -90 to 90 and \"" + key + "Lon\" from -180 to 180";
+            return false;
+        }
+        place = Stop(placeCode, Coordinate(latitude, longitude));
+        return true;
+    }
+    error = "\"" + key + "\" must be the code of a stop, or \"" + key + "Lat\" and \"" + key + "Lon\" a coordinate";
+    return false;
+}
+
+/**
+ * This method writes a path as a JSON array of the codes of its stops
+ * @param path This is the path
+ * @return The return is the array
+ */
+static std::string jsonPath(const std::list<Stop> &path) {
+    std::string result = "[";
+    for (const auto &stop: path) {
+        result += (result.size() > 1 ? "," : "") + jsonString(stop.getCode());
+    }
+    return result + "]";
+}
+
+/**
+ * This method gets the length of a path, the sum of the straight distances between its stops
+ * @param path This is the path
+ * @return The return is the length in meters, written with one decimal
+ */
+static std::string jsonLength(const std::list<Stop> &path) {
+    double length = 0;
+    const Stop *previous = nullptr;
+    for (const auto &stop: path) {
+        if (previous != nullptr) {
+            length += previous->distance(stop);
+        }
+        previous = &stop;
+    }
+    char written[32];
+    std::snprintf(written, sizeof(written), "%.1f", length);
+    return written;
+}
+
+/**
+ * Constructor (the server does not listen yet)
+ * @param graph This is the graph the routes are searched on, it must not change while the server runs
+ * @param nThreads This is the number of threads that search the requests, 0 uses one for every core
+ */
+RouteServer::RouteServer(const Graph &graph, unsigned nThreads) : graph(graph), nThreads(nThreads), listener(-1),
+                                                                  wakeRead(-1), wakeWrite(-1), nextConnection(0),
+                                                                  stopping(false), nRequests(0) {
+    if (this->nThreads == 0) {
+        this->nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    int ends[2];
+    if (pipe(ends) == 0) {
+        wakeRead = ends[0];
+        wakeWrite = ends[1];
+        setNonBlocking(wakeRead);
+        setNonBlocking(wakeWrite);
+    }
+}
+
+/**
+ * Destructor, it closes the sockets and removes the Unix socket
+ */
+RouteServer::~RouteServer() {
+    for (auto &connection: connections) {
+        close(connection.second.fd);
+    }
+    if (listener >= 0) {
+        close(listener);
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+    }
+    if (wakeRead >= 0) {
+        close(wakeRead);
+        close(wakeWrite);
+    }
+}
+
+/**
+ * This method opens the socket the clients connect to
+ * @param address This is a port number (a TCP port of this host, 127.0.0.1) or the path of a Unix socket (a file that
+ * is already there is replaced)
+ * @return The return is false if the socket could not be opened
+ */
+bool RouteServer::listen(const std::string &address) {
+    if (wakeRead < 0 || listener >= 0 || address.empty()) {
+        return false;
+    }
+    bool port = address.find_first_not_of("0123456789") == std::string::npos && address.size() <= 5;
+    if (port) {
+        unsigned long number = std::strtoul(address.c_str(), nullptr, 10);
+        if (number == 0 || number > 65535) {
+            return false;
+        }
+        listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener < 0) {
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in socketAddress = {};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons((uint16_t) number);
+        socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(listener, (sockaddr *) &socketAddress, sizeof(socketAddress)) != 0) {
+            close(listener);
+            listener = -1;
+            return false;
+        }
+    } else {
+        sockaddr_un socketAddress = {};
+        if (address.size() >= sizeof(socketAddress.sun_path)) {
+            return false;
+        }
+        listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            return false;
+        }
+        socketAddress.sun_family = AF_UNIX;
+        address.copy(socketAddress.sun_path, address.size());
+        unlink(address.c_str());
+        if (bind(listener, (sockaddr *) &socketAddress, sizeof(socketAddress)) != 0) {
+            close(listener);
+            listener = -1;
+            return false;
+        }
+        socketPath = address;
+    }
+    if (::listen(listener, SOMAXCONN) != 0 || !setNonBlocking(listener)) {
+        close(listener);
+        listener = -1;
+        if (!socketPath.empty()) {
+            unlink(socketPath.c_str());
+            socketPath.clear();
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * This method runs the event loop until stop is called or the process gets SIGINT or SIGTERM: every pass waits (poll)
+ * for a new connection, a request to read, an answer to write or a request finished by the pool
+ */
+void RouteServer::run() {
+    if (listener < 0) {
+        return;
+    }
+    interrupted = 0;
+    interruptPipe = wakeWrite;
+    std::signal(SIGINT, onInterrupt);
+    std::signal(SIGTERM, onInterrupt);
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < nThreads; ++i) {
+        pool.emplace_back(&RouteServer::work, this);
+    }
+
+    //the first two are the wake pipe and the listener, then one for every connection, in the order of ids
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    while (!interrupted) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) {
+                break;
+            }
+        }
+        fds.clear();
+        ids.clear();
+        fds.push_back({wakeRead, POLLIN, 0});
+        fds.push_back({listener, POLLIN, 0});
+        for (const auto &connection: connections) {
+            //a connection that only waits for the pool is left out, its end would wake the loop over and over
+            const Connection &current = connection.second;
+            short events = (short) ((current.closing || isBlocked(current) ? 0 : POLLIN) |
+                                    (current.output.empty() ? 0 : POLLOUT));
+            fds.push_back({events == 0 ? -1 : current.fd, events, 0});
+            ids.push_back(connection.first);
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (fds[0].revents != 0) {
+            char bytes[256];
+            while (read(wakeRead, bytes, sizeof(bytes)) > 0) {}
+            collectResults();
+        }
+        if (fds[1].revents != 0) {
+            acceptConnections();
+        }
+        for (unsigned i = 0; i < ids.size(); ++i) {
+            auto connection = connections.find(ids[i]);
+            short events = fds[i + 2].revents;
+            if (connection == connections.end() || events == 0) {
+                continue;
+            }
+            Connection &current = connection->second;
+            bool open = true;
+            if (events & (POLLIN | POLLHUP | POLLERR)) {
+                open = readConnection(current, ids[i]);
+            }
+            if (open && (events & POLLOUT)) {
+                open = writeConnection(current) && dispatchRequests(current, ids[i]);
+            }
+            if (!open || isFinished(current)) {
+                closeConnection(connection);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (auto &thread: pool) {
+        thread.join();
+    }
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    interruptPipe = -1;
+}
+
+/**
+ * This method ends the event loop, it can be called from any thread (run returns after the requests being searched
+ * are finished)
+ */
+void RouteServer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    char byte = 0;
+    ssize_t written = write(wakeWrite, &byte, 1);
+    (void) written;
+}
+
+/**
+ * This method is run by every thread of the pool: it takes the next request, searches it with its own workspace and
+ * gives the answer to the event loop, waking it if it has no other answers waiting
+ */
+void RouteServer::work() {
+    SearchWorkspace workspace;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobReady.wait(lock, [this]() { return stopping || !jobs.empty(); });
+            if (stopping) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job.text = answer(job.text, workspace) + "\n";
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake = results.empty();
+            results.push_back(std::move(job));
+        }
+        if (wake) {
+            char byte = 0;
+            ssize_t written = write(wakeWrite, &byte, 1);
+            (void) written;
+        }
+    }
+}
+
+/**
+ * This method accepts every connection waiting on the listener
+ */
+void RouteServer::acceptConnections() {
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            return; //no more connections waiting (or the client gave up before it was accepted)
+        }
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        if (socketPath.empty()) {
+            //an answer is one small write, it should not wait for the acknowledgement of the one before
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        connections[nextConnection++] = {fd, "", "", 0, 0, {}, false};
+    }
+}
+
+/**
+ * This method checks if a connection reached the limits of the requests waiting for their answer or of the answers not
+ * written yet, it is not read until it is under them again
+ * @param connection This is the connection
+ * @return The return is true if the connection has to wait for its answers to be written
+ */
+bool RouteServer::isBlocked(const Connection &connection) {
+    return connection.nextSequence - connection.nextWrite >= MAX_PENDING_REQUESTS ||
+           connection.output.size() >= MAX_PENDING_OUTPUT;
+}
+
+/**
+ * This method checks if a connection is done: the client ended its side and every request it sent was answered
+ * @param connection This is the connection
+ * @return The return is true if the connection can be closed
+ */
+bool RouteServer::isFinished(const Connection &connection) {
+    return connection.closing && connection.input.empty() && connection.nextWrite == connection.nextSequence &&
+           connection.output.empty();
+}
+
+/**
+ * This method reads what a connection sent and gives its whole lines to the pool as requests (when the client ends its
+ * side, what is left after the last line is a request too). It stops reading when the connection is blocked
+ * @param connection This is the connection
+ * @param id This is the id of the connection
+ * @return The return is false if the connection has to be closed (an error or a request that is too long)
+ */
+bool RouteServer::readConnection(Connection &connection, uint64_t id) {
+    char buffer[READ_BUFFER_SIZE];
+    while (!connection.closing && !isBlocked(connection)) {
+        ssize_t size = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (size > 0) {
+            connection.input.append(buffer, size);
+        } else if (size == 0) {
+            connection.closing = true;
+            connection.input += '\n';
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else if (errno != EINTR) {
+            return false;
+        } else {
+            continue;
+        }
+        if (!dispatchRequests(connection, id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * This method gives the whole lines read from a connection to the pool as requests, while the connection is not
+ * blocked (the other lines wait in its input until its answers are written)
+ * @param connection This is the connection
+ * @param id This is the id of the connection
+ * @return The return is false if the connection has to be closed (a request that is too long)
+ */
+bool RouteServer::dispatchRequests(Connection &connection, uint64_t id) {
+    std::vector<Job> read;
+    size_t start = 0;
+    while (!isBlocked(connection)) {
+        size_t end = connection.input.find('\n', start);
+        if (end == std::string::npos) {
+            break;
+        }
+        if (connection.input.find_first_not_of(" \t\r", start) < end) {
+            read.push_back({id, connection.nextSequence++, connection.input.substr(start, end - start)});
+        }
+        start = end + 1;
+    }
+    connection.input.erase(0, start);
+    if (connection.input.size() > MAX_REQUEST_SIZE && connection.input.find('\n') == std::string::npos) {
+        return false;
+    }
+    if (!read.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto &job: read) {
+                jobs.push_back(std::move(job));
+            }
+        }
+        jobReady.notify_all();
+    }
+    return true;
+}
+
+/**
+ * This method closes a connection and takes its requests that the pool did not start yet out of the queue (their
+ * answers would be dropped), so a client that sends many requests and goes away does not leave them to be searched
+ * @param connection This is the connection
+ * @return The return is the connection after it
+ */
+std::unordered_map<uint64_t, RouteServer::Connection>::iterator
+RouteServer::closeConnection(std::unordered_map<uint64_t, Connection>::iterator connection) {
+    uint64_t id = connection->first;
+    close(connection->second.fd);
+    if (connection->second.nextWrite != connection->second.nextSequence) {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [id](const Job &job) { return job.connection == id; }),
+                   jobs.end());
+    }
+    return connections.erase(connection);
+}
+
+/**
+ * This method writes as much of the answers of a connection as the socket takes without waiting
+ * @param connection This is the connection
+ * @return The return is false if the connection has to be closed (the client is gone)
+ */
+bool RouteServer::writeConnection(Connection &connection) {
+    size_t written = 0;
+    while (written < connection.output.size()) {
+        ssize_t size = send(connection.fd, connection.output.data() + written, connection.output.size() - written,
+                            MSG_NOSIGNAL);
+        if (size > 0) {
+            written += size;
+        } else if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else if (size < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    connection.output.erase(0, written);
+    return true;
+}
+
+/**
+ * This method takes the answers finished by the pool and writes them to their connections, in the order of the
+ * requests of every connection (an answer of a connection that was closed is dropped). A connection that got its
+ * answers gives the pool the requests that were waiting for them
+ */
+void RouteServer::collectResults() {
+    std::vector<Job> finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished.swap(results);
+    }
+    for (auto &job: finished) {
+        auto connection = connections.find(job.connection);
+        if (connection == connections.end()) {
+            continue;
+        }
+        Connection &current = connection->second;
+        current.finished[job.sequence] = std::move(job.text);
+        for (auto next = current.finished.begin();
+             next != current.finished.end() && next->first == current.nextWrite; next = current.finished.erase(next)) {
+            current.output += next->second;
+            current.nextWrite++;
+        }
+    }
+    for (auto connection = connections.begin(); connection != connections.end();) {
+        Connection &current = connection->second;
+        bool open = (current.output.empty() || writeConnection(current)) && dispatchRequests(current, connection->first);
+        if (!open || isFinished(current)) {
+            connection = closeConnection(connection);
+        } else {
+            ++connection;
+        }
+    }
+}
+
+/**
+ * This method answers one request. A route request has the ends of the route ("from"/"to" with the code of a stop, or
+ * "fromLat"/"fromLon" and "toLat"/"toLon" with a coordinate) and optionally "search" ("distance" or "stops"), "night"
+ * (true for the night lines), "maxwalk" (meters), "maxlines", "maxzones" and "alternatives" (the number of different
+ * routes wanted, only for the distance search without limits). {"type": "stats"} gets the number of requests answered
+ * and the counters of the route cache. The answer has the "id" of the request, "ok", the stops of the route (or the
+ * routes, or the "error") and "time_us", the time it took in microseconds
+ * @param request This is the request, a JSON object
+ * @param workspace This is the memory the search works on
+ * @return The return is the answer, a JSON object in one line (without the end of the line)
+ */
+std::string RouteServer::answer(const std::string &request, SearchWorkspace &workspace) const {
+    auto begin = std::chrono::steady_clock::now();
+    nRequests++;
+    std::unordered_map<std::string, JsonValue> values;
+    std::string error, body;
+    if (parseJsonObject(request, values, error)) {
+        auto type = values.find("type");
+        if (type != values.end() && type->second.type == 's' && type->second.text == "stats") {
+            const RouteCache &cache = graph.getRouteCache();
+            body = "\"requests\":" + std::to_string(nRequests.load()) +
+                   ",\"cacheHits\":" + std::to_string(cache.getHits()) +
+                   ",\"cacheMisses\":" + std::to_string(cache.getMisses()) +
+                   ",\"cacheSize\":" + std::to_string(cache.getSize());
+        } else if (type != values.end() && !(type->second.type == 's' && type->second.text == "route")) {
+            error = "\"type\" must be \"route\" or \"stats\"";
+        } else {
+            RouteQuery query;
+            query.walkingDistance = DEFAULT_WALKING_DISTANCE;
+            int nAlternatives = 1;
+            auto search = values.find("search");
+            auto night = values.find("night");
+            auto walk = values.find("maxwalk");
+            if (!getPlace(graph, values, "from", "ORIGIN", query.start, error) ||
+                !getPlace(graph, values, "to", "DESTINATION", query.dest, error) ||
+                !getLimit(values, "maxlines", query.nLinesToChange, error) ||
+                !getLimit(values, "maxzones", query.nZones, error) ||
+                !getLimit(values, "alternatives", nAlternatives, error)) {
+                //the error is already written
+            } else if (search != values.end() && !(search->second.type == 's' &&
+                                                   (search->second.text == "distance" ||
+                                                    search->second.text == "stops"))) {
+                error = "\"search\" must be \"distance\" or \"stops\"";
+            } else if (night != values.end() && night->second.type != 'b') {
+                error = "\"night\" must be true or false";
+            } else if (walk != values.end() && (walk->second.type != 'n' || walk->second.number < 0 ||
+                                                walk->second.number > graph.getWalkLayerDistance())) {
+                error = "\"maxwalk\" must be a number of meters from 0 to " +
+                        std::to_string((int) graph.getWalkLayerDistance());
+            } else if (nAlternatives < 1 || nAlternatives > (int) MAX_ALTERNATIVES) {
+                error = "\"alternatives\" must be from 1 to " + std::to_string(MAX_ALTERNATIVES);
+            } else {
+                if (search != values.end() && search->second.text == "stops") {
+                    query.searchType = RouteQuery::LEAST_STOPS;
+                }
+                query.services = night != values.end() && night->second.number != 0 ? Line::NIGHT_SERVICE
+                                                                                    : Line::DAY_SERVICE;
+                if (walk != values.end()) {
+                    query.walkingDistance = walk->second.number;
+                }
+                if (nAlternatives == 1) {
+                    std::list<Stop> path = graph.route(query, workspace);
+                    body = "\"stops\":" + jsonPath(path) + ",\"distance\":" + jsonLength(path);
+                } else if (query.searchType != RouteQuery::SHORTEST_DISTANCE || query.nLinesToChange != INT32_MAX ||
+                           query.nZones != INT32_MAX) {
+                    error = "\"alternatives\" is only for the distance search without limits";
+                } else {
+                    std::vector<std::list<Stop>> paths = graph.alternativeRoutes(query.start, query.dest,
+                                                                                 nAlternatives, query.walkingDistance,
+                                                                                 query.services, workspace);
+                    body = "\"routes\":[";
+                    for (unsigned i = 0; i < paths.size(); ++i) {
+                        body += std::string(i > 0 ? "," : "") + "{\"stops\":" + jsonPath(paths[i]) +
+                                ",\"distance\":" + jsonLength(paths[i]) + "}";
+                    }
+                    body += "]";
+                }
+            }
+        }
+    }
+
+    auto id = values.find("id");
+    std::string answer = "{\"id\":" + (id != values.end() ? id->second.raw : std::string("null"));
+    answer += error.empty() ? ",\"ok\":true," + body : ",\"ok\":false,\"error\":" + jsonString(error);
+    long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+    return answer + ",\"time_us\":" + std::to_string(elapsed) + "}";
+}
@@ -0,0 +1,135 @@
+/**
+ * @file RouteServer.h
+ * @brief This file contains the implementation of the server that answers route requests over a socket and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#ifndef AEDAGRAFOS_ROUTESERVER_H
+#define AEDAGRAFOS_ROUTESERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include "Graph.h"
+
+/**
+ * This is a long running server that answers route requests on a graph loaded once. The clients connect to a local
+ * socket (a Unix socket or a TCP port of this host) and send one JSON object per line, for example
+ * {"id": 1, "from": "1AL2", "to": "HSJ12", "search": "distance", "night": false, "maxwalk": 100, "maxlines": 2}
+ * and get one JSON object per line with the stops of the route and the time it took (the answers of a connection come
+ * in the order of its requests). A connection with too many requests waiting for their answers, or too many answers
+ * not written, is not read until they are written.
+ * One thread runs the event loop (poll): it accepts the connections, reads the requests and writes the answers. The
+ * requests are searched by a pool of threads, each with its own workspace, and a finished answer wakes the event loop
+ * through a pipe. The graph is only read, so the searches share it (and its route cache)
+ * @param graph This is the graph the routes are searched on
+ * @param nThreads This is the number of threads of the pool
+ * @param listener This is the socket the connections arrive at (-1 if it is not listening)
+ * @param socketPath This is the path of the Unix socket (empty for a TCP port), removed when the server ends
+ * @param wakeRead This is the end of the pipe the event loop waits on
+ * @param wakeWrite This is the end of the pipe the threads of the pool write to when they finish a request
+ * @param connections This is the open connections, by their id
+ * @param nextConnection This is the id of the next connection accepted
+ * @param jobs This is the requests waiting for a thread of the pool
+ * @param results This is the answers finished by the pool that the event loop did not write yet
+ * @param mutex This is the lock of jobs, results and stopping
+ * @param jobReady This is signaled when a request is added to jobs or the server stops
+ * @param stopping This is true when the server is ending
+ * @param nRequests This is the number of requests answered
+ */
+class RouteServer {
+public:
+    explicit RouteServer(const Graph &graph, unsigned nThreads = 0);
+
+    ~RouteServer();
+
+    RouteServer(const RouteServer &) = delete;
+
+    RouteServer &operator=(const RouteServer &) = delete;
+
+    bool listen(const std::string &address);
+
+    void run();
+
+    void stop();
+
+    std::string answer(const std::string &request, SearchWorkspace &workspace) const;
+
+private:
+    /**
+     * This is a client connected to the server
+     * @param fd This is the socket of the connection
+     * @param input This is what was read and was not given to the pool yet (a line not whole, or lines that wait while the
+     * connection is blocked)
+     * @param output This is what was not written yet
+     * @param nextSequence This is the number that the next request of the connection gets
+     * @param nextWrite This is the number of the next answer to write (the answers are written in order)
+     * @param finished This is the answers that are finished but wait for an earlier one
+     * @param closing This is true when the client ended its side, the connection closes after the last answer
+     */
+    struct Connection {
+        int fd;
+        std::string input;
+        std::string output;
+        uint64_t nextSequence;
+        uint64_t nextWrite;
+        std::map<uint64_t, std::string> finished;
+        bool closing;
+    };
+
+    /**
+     * This is a request or its answer, with the connection and the position it has there
+     */
+    struct Job {
+        uint64_t connection;
+        uint64_t sequence;
+        std::string text;
+    };
+
+    const Graph &graph;
+    unsigned nThreads;
+    int listener;
+    std::string socketPath;
+    int wakeRead;
+    int wakeWrite;
+    std::unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnection;
+    std::deque<Job> jobs;
+    std::vector<Job> results;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    bool stopping;
+    mutable std::atomic<uint64_t> nRequests;
+
+    void work();
+
+    void acceptConnections();
+
+    static bool isBlocked(const Connection &connection);
+
+    static bool isFinished(const Connection &connection);
+
+    bool readConnection(Connection &connection, uint64_t id);
+
+    bool dispatchRequests(Connection &connection, uint64_t id);
+
+    bool writeConnection(Connection &connection);
+
+    std::unordered_map<uint64_t, Connection>::iterator
+    closeConnection(std::unordered_map<uint64_t, Connection>::iterator connection);
+
+    void collectResults();
+};
+
+
+#endif //AEDAGRAFOS_ROUTESERVER_H
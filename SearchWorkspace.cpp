@@ -0,0 +1,123 @@
+/**
+ * @file SearchWorkspace.cpp
+ * @brief This file contains the implementation of the functions in SearchWorkspace.h
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 27/1/2022
+ */
+
+#include <cstdint>
+#include <algorithm>
+#include "SearchWorkspace.h"
+
+/**
+ * This is the value of the distance of a node that was not reached and of the predecessor of a node without one
+ */
+static const double UNREACHED = INT32_MAX;
+static const unsigned NO_PREVIOUS = UINT32_MAX;
+
+const char SearchWorkspace::FORWARD;
+const char SearchWorkspace::BACKWARD;
+
+/**
+ * Constructor (the memory is only allocated by the first search)
+ */
+SearchWorkspace::SearchWorkspace() : version(0), nNodes(0) {}
+
+/**
+ * This method starts a new search on the workspace, keeping the memory it already has. The nodes are not reset here,
+ * only when the search touches them
+ * @param nNodes This is the number of nodes of the graph that is going to be searched
+ */
+void SearchWorkspace::prepare(unsigned nNodes) {
+    this->nNodes = nNodes;
+    labels.clear();
+    heap.clear();
+    fifo.clear();
+    backwardHeap.clear();
+    backwardFifo.clear();
+    if (stamp.size() < nNodes) {
+        settled.resize(nNodes);
+        bestDistance.resize(nNodes);
+        previous.resize(nNodes);
+        visited.resize(nNodes);
+        backwardDistance.resize(nNodes);
+        backwardPrevious.resize(nNodes);
+        stamp.resize(nNodes, 0);
+    }
+    //after the versions run out every node is marked as not touched once
+    if (++version == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        version = 1;
+    }
+}
+
+/**
+ * This method resets the state of a node the first time the current search touches it
+ * @param node This is the index of the node
+ */
+void SearchWorkspace::touch(unsigned node) {
+    if (stamp[node] == version) {
+        return;
+    }
+    stamp[node] = version;
+    settled[node].clear();
+    bestDistance[node] = UNREACHED;
+    previous[node] = NO_PREVIOUS;
+    visited[node] = false;
+    backwardDistance[node] = UNREACHED;
+    backwardPrevious[node] = NO_PREVIOUS;
+}
+
+/**
+ * This method checks if the last search (a shortest path tree) got to a node
+ * @param node This is the index of the node
+ * @return The return is true if the node was reached
+ */
+bool SearchWorkspace::isReached(unsigned node) const {
+    return node < nNodes && stamp[node] == version && bestDistance[node] < UNREACHED;
+}
+
+/**
+ * This method gets the distance the last search (a shortest path tree) found to a node
+ * @param node This is the index of the node
+ * @return The return is the distance in meters, or INT32_MAX if the node was not reached
+ */
+double SearchWorkspace::getDistance(unsigned node) const {
+    return isReached(node) ? bestDistance[node] : UNREACHED;
+}
+
+/**
+ * This method gets the node that comes before a node on the path the last search (a shortest path tree) found to it
+ * @param node This is the index of the node
+ * @return The return is the index of the previous node, or UINT32_MAX on the start and on the nodes not reached
+ */
+unsigned SearchWorkspace::getPrevious(unsigned node) const {
+    return isReached(node) ? previous[node] : NO_PREVIOUS;
+}
+
+/**
+ * This method copies the distances found by the last search (a shortest path tree) to every node
+ * @return The return is a vector with the distance to every node, INT32_MAX on the nodes that were not reached
+ */
+std::vector<double> SearchWorkspace::getDistances() const {
+    std::vector<double> distances(nNodes);
+    for (unsigned node = 0; node < nNodes; ++node) {
+        distances[node] = getDistance(node);
+    }
+    return distances;
+}
+
+/**
+ * This method copies the predecessors found by the last search (a shortest path tree) for every node
+ * @return The return is a vector with the previous node of every node, UINT32_MAX on the start and on the nodes that
+ * were not reached
+ */
+std::vector<unsigned> SearchWorkspace::getPredecessors() const {
+    std::vector<unsigned> predecessors(nNodes);
+    for (unsigned node = 0; node < nNodes; ++node) {
+        predecessors[node] = getPrevious(node);
+    }
+    return predecessors;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file SearchWorkspace.h
+ * @brief This file contains the memory a search on the graph works on, so it can be reused between searches
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 27/1/2022
+ */
+
+#ifndef AEDAGRAFOS_SEARCHWORKSPACE_H
+#define AEDAGRAFOS_SEARCHWORKSPACE_H
+
+#include <vector>
+#include <bitset>
+#include <utility>
+#include "Stop.h"
+
+/**
+ * This is the memory used by the searches of the graph. It is owned by whoever calls the search and can be passed to
+ * many searches (one at a time), so after the first search the vectors are already allocated. A workspace must not be
+ * used by two threads at the same time, but every thread can have its own to search the same graph.
+ * The state of a node is only reset when a search first touches it: every node keeps the version of the last search
+ * that touched it, so starting a new search costs the same no matter how big the graph is
+ * @param labels This is every label created by the dijkstra search, they point to the label they came from
+ * @param settled This is the labels that were already expanded on every node
+ * @param bestDistance This is the shortest distance found so far to every node (when only the distance is tracked)
+ * @param heap This is the storage of the priority queue of the dijkstra search (distance and label)
+ * @param previous This is the predecessor of every node in the BFS search
+ * @param visited This marks the nodes that were reached by the BFS search (FORWARD and BACKWARD for the bidirectional
+ * searches)
+ * @param fifo This is the storage of the queue of the BFS search
+ * @param backwardDistance This is the distance from every node to the destination found by a bidirectional search
+ * @param backwardPrevious This is the node that comes after every node on the way to the destination
+ * @param backwardHeap This is the priority queue of the backward side of the bidirectional dijkstra
+ * @param backwardFifo This is the queue of the backward side of the bidirectional BFS
+ * @param roundDistance This is the shortest distance to every stop after every round of the round based router
+ * @param roundSteps This is how every stop was reached in every round of the round based router
+ * @param marked This marks the stops improved in the current round of the round based router
+ * @param markedStops This is the list of the marked stops
+ * @param routeStart This is the first position to scan of every route in the current round (NO_ROUTE if it is not
+ * scanned)
+ * @param queuedRoutes This is the list of the routes to scan in the current round
+ * @param arrivalTime This is the earliest time every stop is reached by the connection scan (and after them the earliest
+ * time every stop is reached without walking at the end), the profile search keeps there the time to walk from every
+ * stop to the destination and from the start to every stop
+ * @param connectionSteps This is how the connection scan reached every stop (in the same positions as arrivalTime)
+ * @param tripBoarding This is the connection where every trip was boarded by the connection scan (NO_CONNECTION if it
+ * was not)
+ * @param tripArrival This is the earliest arrival at the destination staying on every trip, found by the profile search
+ * @param profiles This is the departures of every stop found by the profile search (the time a bus is taken there and
+ * the time of arrival at the destination), from the latest to the earliest
+ * @param pathUses This is the number of the paths found by the alternative routes search that go through every node
+ * @param stamp This is the version of the last search that touched every node
+ * @param version This is the version of the current search
+ * @param nNodes This is the number of nodes of the current search
+ */
+class SearchWorkspace {
+public:
+    static const char FORWARD = 1;
+    static const char BACKWARD = 2;
+
+    /**
+     * This is a partial path kept by the dijkstra search on a node
+     * @param distance This is the distance from the start in meters
+     * @param node This is the node the path ends at
+     * @param line This is the interned line used to get to the node (0 is walking)
+     * @param boardings This is the number of buses taken
+     * @param zones This is the set of zones the path went through, one bit for each interned zone (the zones after
+     * the last bit share it)
+     * @param parent This is the label the path came from, or -1 on the start
+     */
+    struct Label {
+        double distance;
+        unsigned node;
+        unsigned line;
+        unsigned boardings;
+        std::bitset<Stop::MAX_ZONES> zones;
+        unsigned parent;
+    };
+
+    /**
+     * This is how the round based router reached a stop in a round
+     * @param previous This is the stop the step came from (NO_ROUTE on the stops where the search starts)
+     * @param round This is the round of the label of the previous stop
+     * @param route This is the route taken (NO_ROUTE when walking)
+     * @param boardPosition This is the position in the route where the bus was taken
+     * @param position This is the position in the route where the bus was left
+     */
+    struct RoundStep {
+        unsigned previous;
+        unsigned round;
+        unsigned route;
+        unsigned boardPosition;
+        unsigned position;
+    };
+
+    /**
+     * This is how the connection scan reached a stop
+     * @param previous This is the stop the step came from (NO_CONNECTION on the stops where the search starts)
+     * @param boarding This is the connection where the bus was taken (NO_CONNECTION when walking)
+     * @param alighting This is the connection where the bus was left
+     */
+    struct ConnectionStep {
+        unsigned previous;
+        unsigned boarding;
+        unsigned alighting;
+    };
+
+    SearchWorkspace();
+
+    void prepare(unsigned nNodes);
+
+    bool isReached(unsigned node) const;
+
+    double getDistance(unsigned node) const;
+
+    unsigned getPrevious(unsigned node) const;
+
+    std::vector<double> getDistances() const;
+
+    std::vector<unsigned> getPredecessors() const;
+
+private:
+    friend class Graph;
+    friend class ContractionHierarchy;
+    friend class Raptor;
+    friend class Timetable;
+
+    std::vector<Label> labels;
+    std::vector<std::vector<unsigned>> settled;
+    std::vector<double> bestDistance;
+    std::vector<std::pair<double, unsigned>> heap;
+    std::vector<unsigned> previous;
+    std::vector<char> visited;
+    std::vector<unsigned> fifo;
+    std::vector<double> backwardDistance;
+    std::vector<unsigned> backwardPrevious;
+    std::vector<std::pair<double, unsigned>> backwardHeap;
+    std::vector<unsigned> backwardFifo;
+    std::vector<std::vector<double>> roundDistance;
+    std::vector<std::vector<RoundStep>> roundSteps;
+    std::vector<char> marked;
+    std::vector<unsigned> markedStops;
+    std::vector<unsigned> routeStart;
+    std::vector<unsigned> queuedRoutes;
+    std::vector<unsigned> arrivalTime;
+    std::vector<ConnectionStep> connectionSteps;
+    std::vector<unsigned> tripBoarding;
+    std::vector<unsigned> tripArrival;
+    std::vector<std::vector<std::pair<unsigned, unsigned>>> profiles;
+    std::vector<unsigned> pathUses;
+    std::vector<unsigned> stamp;
+    unsigned version;
+    unsigned nNodes;
+
+    void touch(unsigned node);
+};
+
+
+#endif //AEDAGRAFOS_SEARCHWORKSPACE_H
@@ -0,0 +1,152 @@
+/**
+ * @file Snapshot.cpp
+ * @brief This file contains the implementation of the functions in Snapshot.h (the binary snapshot of the network)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <fstream>
+#include "Snapshot.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/**
+ * This is the start of a snapshot file and the version of its layout, a file with other values is not mapped (the
+ * version must change every time the content written by the graph changes)
+ */
+static const char SNAPSHOT_MAGIC[4] = {'A', 'E', 'D', 'S'};
+static const uint32_t SNAPSHOT_VERSION = 4;
+
+/**
+ * Constructor (an empty snapshot, ready to be written)
+ */
+Snapshot::Snapshot() : mapped(nullptr), mappedSize(0), cursor(0) {}
+
+/**
+ * Destructor, it releases the mapped file
+ */
+Snapshot::~Snapshot() {
+    unmap();
+}
+
+/**
+ * This method adds a string (its size and then its characters) to the end of the snapshot being written
+ * @param value This is the string
+ */
+void Snapshot::putString(const std::string &value) {
+    put<uint32_t>(value.size());
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+/**
+ * This method gets the next string of the mapped snapshot
+ * @param value This is where the string is stored
+ * @return The return is true if the snapshot had the whole string
+ */
+bool Snapshot::getString(std::string &value) {
+    uint32_t size;
+    if (!get(size) || size > mappedSize - cursor) {
+        return false;
+    }
+    value.assign(mapped + cursor, size);
+    cursor += size;
+    return true;
+}
+
+/**
+ * This method gets the number of bytes of the mapped snapshot that were not read yet, a count read from the file is
+ * checked against it before anything is allocated for it
+ * @return The return is the number of bytes left
+ */
+size_t Snapshot::getRemaining() const {
+    return mappedSize - cursor;
+}
+
+/**
+ * This method writes the snapshot to a file, after the magic and the version
+ * @param path This is the path of the file
+ * @return The return is true if the file was written
+ */
+bool Snapshot::save(const std::string &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    file.write(reinterpret_cast<const char *>(&SNAPSHOT_VERSION), sizeof(SNAPSHOT_VERSION));
+    file.write(buffer.data(), buffer.size());
+    return bool(file);
+}
+
+/**
+ * This method maps a snapshot file into memory so its values can be read, it is refused if it does not start with
+ * the magic and the version of this layout
+ * @param path This is the path of the file
+ * @return The return is true if the file was mapped
+ */
+bool Snapshot::map(const std::string &path) {
+    unmap();
+#ifndef _WIN32
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        ::close(descriptor);
+        return false;
+    }
+    void *address = ::mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    ::close(descriptor); //the mapping stays valid after the file is closed
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mapped = static_cast<const char *>(address);
+    mappedSize = status.st_size;
+#else
+    //there is no mmap, the file is read into memory in one go
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    fileBuffer.resize((size_t) file.tellg());
+    file.seekg(0);
+    if (!file.read(fileBuffer.data(), fileBuffer.size())) {
+        fileBuffer.clear();
+        return false;
+    }
+    mapped = fileBuffer.data();
+    mappedSize = fileBuffer.size();
+#endif
+    cursor = 0;
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t version;
+    if (!get(magic) || std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 || !get(version) ||
+        version != SNAPSHOT_VERSION) {
+        unmap();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * This method releases the mapped file, the values already read stay valid (they were copied)
+ */
+void Snapshot::unmap() {
+#ifndef _WIN32
+    if (mapped != nullptr) {
+        ::munmap(const_cast<char *>(mapped), mappedSize);
+    }
+#endif
+    fileBuffer.clear();
+    mapped = nullptr;
+    mappedSize = 0;
+    cursor = 0;
+}
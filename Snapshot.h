@@ -0,0 +1,116 @@
+/**
+ * @file Snapshot.h
+ * @brief This file contains the implementation of the binary snapshot of the built network and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#ifndef AEDAGRAFOS_SNAPSHOT_H
+#define AEDAGRAFOS_SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+
+/**
+ * This is a versioned binary file with the flat arrays of a built network, so a start does not have to read and parse
+ * the dataset again. A snapshot is written by putting the values and arrays in order and saving it, and read by
+ * mapping the file into memory (mmap, the pages are read only and shared between processes) and getting them back in
+ * the same order: an array is one bulk copy, nothing is parsed. Getting a value past the end of the file fails, so a
+ * truncated snapshot is refused
+ * @param buffer This is the content of a snapshot being written
+ * @param mapped This is the start of the content of a mapped snapshot (nullptr if none is mapped)
+ * @param mappedSize This is the size in bytes of the mapped content
+ * @param cursor This is the position of the next value to get from the mapped content
+ * @param fileBuffer This is the content of the file when it can not be mapped (it is read into memory instead)
+ */
+class Snapshot {
+public:
+    Snapshot();
+
+    ~Snapshot();
+
+    Snapshot(const Snapshot &) = delete;
+
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    bool save(const std::string &path) const;
+
+    bool map(const std::string &path);
+
+    void unmap();
+
+    /**
+     * This method adds a value (a number or a struct without pointers) to the end of the snapshot being written
+     * @param value This is the value
+     */
+    template<typename T>
+    void put(const T &value) {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * This method adds an array (its size and then its elements) to the end of the snapshot being written
+     * @param values This is the array
+     */
+    template<typename T>
+    void putArray(const std::vector<T> &values) {
+        put<uint64_t>(values.size());
+        const char *bytes = reinterpret_cast<const char *>(values.data());
+        buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    void putString(const std::string &value);
+
+    /**
+     * This method gets the next value of the mapped snapshot
+     * @param value This is where the value is stored
+     * @return The return is true if the snapshot had the value
+     */
+    template<typename T>
+    bool get(T &value) {
+        if (mappedSize - cursor < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, mapped + cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+
+    /**
+     * This method gets the next array of the mapped snapshot, copied into a vector in one go
+     * @param values This is where the array is stored
+     * @return The return is true if the snapshot had the whole array
+     */
+    template<typename T>
+    bool getArray(std::vector<T> &values) {
+        uint64_t size;
+        if (!get(size) || size > (mappedSize - cursor) / sizeof(T)) {
+            return false;
+        }
+        values.resize(size);
+        if (size > 0) {
+            std::memcpy(values.data(), mapped + cursor, size * sizeof(T));
+        }
+        cursor += size * sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string &value);
+
+    size_t getRemaining() const;
+
+private:
+    std::vector<char> buffer;
+    const char *mapped;
+    size_t mappedSize;
+    size_t cursor;
+    std::vector<char> fileBuffer;
+};
+
+
+#endif //AEDAGRAFOS_SNAPSHOT_H
@@ -0,0 +1,268 @@
+/**
+ * @file SpatialGrid.cpp
+ * @brief This file contains the implementation of the functions in SpatialGrid.h (the spatial index over coordinates)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 22/1/2022
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "SpatialGrid.h"
+
+/**
+ * The grid works on a flat projection, this is how much bigger than the radius a distance on it may be while still
+ * being inside the radius on the sphere (the projection is exact up to a tiny curvature error)
+ */
+static const double PROJECTION_SLACK = 1.001;
+
+/**
+ * Constructor (an empty grid)
+ */
+SpatialGrid::SpatialGrid() : cellSize(1), metersPerDegreeLat(0), metersPerDegreeLon(0), minLat(0), minLon(0),
+                             nColumns(0), nRows(0), cellOffsets(1, 0) {}
+
+/**
+ * Constructor, it places every point in its cell
+ * @param points This is the coordinates to index
+ * @param cellSize This is the side of a cell in meters, it should be close to the radius of the usual queries (it is
+ * increased if the grid would have a lot more cells than points)
+ */
+SpatialGrid::SpatialGrid(const std::vector<Coordinate> &points, double cellSize) : points(points), cellSize(cellSize) {
+    const double earthRadius = 6371000; //radius of Earth in meters
+    metersPerDegreeLat = earthRadius * M_PI / 180.0;
+
+    if (points.empty()) {
+        metersPerDegreeLon = metersPerDegreeLat;
+        minLat = minLon = 0;
+        nColumns = nRows = 0;
+        cellOffsets = {0};
+        return;
+    }
+
+    minLat = points[0].getLat();
+    minLon = points[0].getLon();
+    double maxLat = minLat, maxLon = minLon;
+    for (const auto &point: points) {
+        minLat = std::min(minLat, point.getLat());
+        maxLat = std::max(maxLat, point.getLat());
+        minLon = std::min(minLon, point.getLon());
+        maxLon = std::max(maxLon, point.getLon());
+    }
+    double farthestLat = std::max(std::fabs(minLat), std::fabs(maxLat));
+    metersPerDegreeLon = metersPerDegreeLat * std::cos(farthestLat * M_PI / 180.0);
+
+    double width = (maxLon - minLon) * metersPerDegreeLon;
+    double height = (maxLat - minLat) * metersPerDegreeLat;
+    if (this->cellSize <= 0) {
+        this->cellSize = 1;
+    }
+    //keep the number of cells in the order of the number of points
+    double maxCells = 4.0 * points.size() + 16;
+    double nCells = (width / this->cellSize + 1) * (height / this->cellSize + 1);
+    if (nCells > maxCells) {
+        this->cellSize *= std::sqrt(nCells / maxCells);
+    }
+    nColumns = (long) (width / this->cellSize) + 1;
+    nRows = (long) (height / this->cellSize) + 1;
+
+    cosLat.reserve(points.size());
+    for (const auto &point: points) {
+        cosLat.push_back(std::cos(point.getLat() * M_PI / 180.0));
+    }
+
+    //counting sort of the points by cell
+    std::vector<unsigned> pointCell(points.size());
+    cellOffsets.assign(nColumns * nRows + 1, 0);
+    for (unsigned i = 0; i < points.size(); ++i) {
+        pointCell[i] = row(points[i].getLat()) * nColumns + column(points[i].getLon());
+        cellOffsets[pointCell[i] + 1]++;
+    }
+    for (long cell = 0; cell < nColumns * nRows; ++cell) {
+        cellOffsets[cell + 1] += cellOffsets[cell];
+    }
+    cellPoints.resize(points.size());
+    std::vector<unsigned> next(cellOffsets.begin(), cellOffsets.end() - 1);
+    for (unsigned i = 0; i < points.size(); ++i) {
+        cellPoints[next[pointCell[i]]++] = i;
+    }
+}
+
+/**
+ * This method gets the column of the grid a longitude falls in, a longitude outside of the grid gets -1 or nColumns (so
+ * a far or not finite one is never cast to a column that does not fit)
+ * @param lon This is the longitude
+ * @return The return is the column
+ */
+long SpatialGrid::column(double lon) const {
+    double cell = std::floor((lon - minLon) * metersPerDegreeLon / cellSize);
+    if (!(cell >= 0)) {
+        return -1;
+    }
+    return cell >= nColumns ? nColumns : (long) cell;
+}
+
+/**
+ * This method gets the row of the grid a latitude falls in, a latitude outside of the grid gets -1 or nRows (like
+ * column)
+ * @param lat This is the latitude
+ * @return The return is the row
+ */
+long SpatialGrid::row(double lat) const {
+    double cell = std::floor((lat - minLat) * metersPerDegreeLat / cellSize);
+    if (!(cell >= 0)) {
+        return -1;
+    }
+    return cell >= nRows ? nRows : (long) cell;
+}
+
+/**
+ * This method calculates the distance between a coordinate and a point of the grid, it is the same haversine formula of
+ * Coordinate::haversine but using the cached cosines of the latitudes
+ * @param center This is the coordinate
+ * @param centerCosLat This is the cosine of the latitude of the coordinate
+ * @param point This is the index of the point
+ * @return The return is the distance in meters
+ */
+double SpatialGrid::distance(const Coordinate &center, double centerCosLat, unsigned point) const {
+    const double earthRadius = 6371000; //radius of Earth in meters
+    double distLatRad = (points[point].getLat() * M_PI / 180.0 - center.getLat() * M_PI / 180.0);
+    double distLonRad = (points[point].getLon() * M_PI / 180.0 - center.getLon() * M_PI / 180.0);
+    double sinLat = std::sin(distLatRad / 2);
+    double sinLon = std::sin(distLonRad / 2);
+    double a = sinLat * sinLat + sinLon * sinLon * centerCosLat * cosLat[point];
+    return 2 * std::asin(std::sqrt(a)) * earthRadius;
+}
+
+/**
+ * This method finds all the points that are inside a circle
+ * @param center This is the center of the circle
+ * @param radius This is the radius of the circle in meters
+ * @return The return is a vector with the index of every point inside the circle and its distance to the center in
+ * meters, in no particular order
+ */
+std::vector<std::pair<unsigned, double>> SpatialGrid::withinRadius(const Coordinate &center, double radius) const {
+    std::vector<std::pair<unsigned, double>> found;
+    withinRadius(center, radius, found);
+    return found;
+}
+
+/**
+ * This method finds all the points that are inside a circle, reusing a buffer for the result
+ * @param center This is the center of the circle
+ * @param radius This is the radius of the circle in meters
+ * @param found This is where the index of every point inside the circle and its distance to the center are stored (the
+ * previous content is discarded)
+ */
+void SpatialGrid::withinRadius(const Coordinate &center, double radius, std::vector<std::pair<unsigned, double>> &found) const {
+    found.clear();
+    if (!(radius >= 0) || points.empty() || !std::isfinite(center.getLat()) || !std::isfinite(center.getLon())) {
+        return;
+    }
+    double searchRadius = radius * PROJECTION_SLACK + 1;
+    double centerCosLat = std::cos(center.getLat() * M_PI / 180.0);
+    //only the cells that overlap the square around the circle are looked at
+    double lonReach = searchRadius / metersPerDegreeLon;
+    double latReach = searchRadius / metersPerDegreeLat;
+    long firstColumn = std::max(0L, column(center.getLon() - lonReach));
+    long lastColumn = std::min(nColumns - 1, column(center.getLon() + lonReach));
+    long firstRow = std::max(0L, row(center.getLat() - latReach));
+    long lastRow = std::min(nRows - 1, row(center.getLat() + latReach));
+
+    for (long r = firstRow; r <= lastRow; ++r) {
+        for (long c = firstColumn; c <= lastColumn; ++c) {
+            long cell = r * nColumns + c;
+            for (unsigned p = cellOffsets[cell]; p < cellOffsets[cell + 1]; ++p) {
+                const Coordinate &point = points[cellPoints[p]];
+                //cheap flat distance first, the haversine is only computed for the points that may be inside
+                double dx = (point.getLon() - center.getLon()) * metersPerDegreeLon;
+                double dy = (point.getLat() - center.getLat()) * metersPerDegreeLat;
+                if (dx * dx + dy * dy > searchRadius * searchRadius) {
+                    continue;
+                }
+                double pointDistance = distance(center, centerCosLat, cellPoints[p]);
+                if (pointDistance <= radius) {
+                    found.emplace_back(cellPoints[p], pointDistance);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * This method finds the points that are closer to a coordinate, looking at rings of cells around it until no point
+ * outside the rings can be closer than the ones already found. A coordinate outside of the grid starts from the cell of
+ * the grid closest to it, so the rings never go over cells that are not in the grid
+ * @param center This is the coordinate
+ * @param k This is the number of points to find
+ * @return The return is a vector with the index of the k closer points (or all if there are less than k) and their
+ * distance to the center in meters, from the closer to the farthest
+ */
+std::vector<std::pair<unsigned, double>> SpatialGrid::nearest(const Coordinate &center, unsigned k) const {
+    std::vector<std::pair<unsigned, double>> found;
+    k = std::min<unsigned>(k, points.size());
+    if (k == 0 || !std::isfinite(center.getLat()) || !std::isfinite(center.getLon())) {
+        return found;
+    }
+    auto closer = [](const std::pair<unsigned, double> &a, const std::pair<unsigned, double> &b) {
+        return a.second < b.second;
+    };
+    double centerCosLat = std::cos(center.getLat() * M_PI / 180.0);
+    //the rings go around the cell of the grid closest to the center, a cell d cells away from it is still at least d
+    //cells away from the cell of the center, so the bound of the rings holds
+    long centerColumn = std::min(std::max(column(center.getLon()), 0L), nColumns - 1);
+    long centerRow = std::min(std::max(row(center.getLat()), 0L), nRows - 1);
+    long lastRing = std::max(std::max(centerColumn, nColumns - 1 - centerColumn),
+                             std::max(centerRow, nRows - 1 - centerRow));
+
+    for (long ring = 0; ring <= lastRing; ++ring) {
+        for (long r = centerRow - ring; r <= centerRow + ring; ++r) {
+            if (r < 0 || r >= nRows) continue;
+            //the rows in the middle of the ring only have its two side cells
+            long step = (r == centerRow - ring || r == centerRow + ring) ? 1 : 2 * ring;
+            for (long c = centerColumn - ring; c <= centerColumn + ring; c += std::max(step, 1L)) {
+                if (c < 0 || c >= nColumns) continue;
+                long cell = r * nColumns + c;
+                for (unsigned p = cellOffsets[cell]; p < cellOffsets[cell + 1]; ++p) {
+                    found.emplace_back(cellPoints[p], distance(center, centerCosLat, cellPoints[p]));
+                }
+            }
+        }
+        if (found.size() >= k) {
+            std::nth_element(found.begin(), found.begin() + (k - 1), found.end(), closer);
+            //every point outside the rings is at least this far away
+            if (found[k - 1].second * PROJECTION_SLACK <= ring * cellSize) {
+                break;
+            }
+        }
+    }
+    std::sort(found.begin(), found.end(), closer);
+    found.resize(std::min<size_t>(k, found.size()));
+    return found;
+}
+
+/**
+ * This method gets the side of a cell of the grid
+ * @return The return is the size of a cell in meters
+ */
+double SpatialGrid::getCellSize() const {
+    return cellSize;
+}
+
+/**
+ * This method gets the scale of the flat projection of the grid along the latitude
+ * @return The return is how many meters a degree of latitude has
+ */
+double SpatialGrid::getMetersPerDegreeLat() const {
+    return metersPerDegreeLat;
+}
+
+/**
+ * This method gets the scale of the flat projection of the grid along the longitude, it is taken at the point farthest
+ * from the equator so no distance between the points is overestimated
+ * @return The return is how many meters a degree of longitude has
+ */
+double SpatialGrid::getMetersPerDegreeLon() const {
+    return metersPerDegreeLon;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file SpatialGrid.h
+ * @brief This file contains the implementation of a spatial index over coordinates and its methods definition
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 22/1/2022
+ */
+
+#ifndef AEDAGRAFOS_SPATIALGRID_H
+#define AEDAGRAFOS_SPATIALGRID_H
+
+#include <vector>
+#include <utility>
+#include "Coordinate.h"
+
+/**
+ * This is a uniform grid over a set of coordinates, every point is stored in the square cell it falls in so radius and
+ * nearest neighbour queries only have to look at the cells around the query point
+ * @param points This is the coordinates that were indexed, a point is identified by its position in this vector
+ * @param cosLat This is the cosine of the latitude of every point, kept to make the haversine cheaper
+ * @param cellSize This is the side of a cell in meters
+ * @param metersPerDegreeLat This is how many meters a degree of latitude has
+ * @param metersPerDegreeLon This is how many meters a degree of longitude has (taken at the latitude farthest from the
+ * equator, so the grid never underestimates a distance)
+ * @param minLat This is the lowest latitude of the points
+ * @param minLon This is the lowest longitude of the points
+ * @param nColumns This is the number of cells along the longitude
+ * @param nRows This is the number of cells along the latitude
+ * @param cellOffsets This is the position in cellPoints of the first point of every cell
+ * @param cellPoints This is the index of the points, grouped by cell
+ */
+class SpatialGrid {
+public:
+    SpatialGrid();
+
+    SpatialGrid(const std::vector<Coordinate> &points, double cellSize);
+
+    std::vector<std::pair<unsigned, double>> withinRadius(const Coordinate &center, double radius) const;
+
+    void withinRadius(const Coordinate &center, double radius, std::vector<std::pair<unsigned, double>> &found) const;
+
+    std::vector<std::pair<unsigned, double>> nearest(const Coordinate &center, unsigned k) const;
+
+    double getCellSize() const;
+
+    double getMetersPerDegreeLat() const;
+
+    double getMetersPerDegreeLon() const;
+
+private:
+    std::vector<Coordinate> points;
+    std::vector<double> cosLat;
+    double cellSize;
+    double metersPerDegreeLat;
+    double metersPerDegreeLon;
+    double minLat;
+    double minLon;
+    long nColumns;
+    long nRows;
+    std::vector<unsigned> cellOffsets;
+    std::vector<unsigned> cellPoints;
+
+    long column(double lon) const;
+    long row(double lat) const;
+    double distance(const Coordinate &center, double centerCosLat, unsigned point) const;
+};
+
+
+#endif //AEDAGRAFOS_SPATIALGRID_H
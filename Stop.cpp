@@ -9,6 +9,9 @@
 
 #include "Stop.h"
 
+const unsigned Stop::NO_ZONE;
+const unsigned Stop::MAX_ZONES;
+
 /**
  * Constructor
  * @param code This is the code of the bus stop
@@ -17,18 +20,18 @@
  * @param coordinate This is the coordinates of the bus stop
  */
 Stop::Stop(const std::string &code, const std::string &name, const std::string &zone, Coordinate coordinate)
-        : Code(code), Name(name), Zone(zone), coordinate(coordinate), isVisited(false), walkNeighbours({}), lineNeighbours({}){}
+        : Code(code), Name(name), Zone(zone), zoneId(NO_ZONE), coordinate(coordinate), isVisited(false){}
 
 /**
  * Constructor
  * @param stopCords This is the coordinates of the bus stop
  */
-Stop::Stop(std::string code, Coordinate stopCords): Code(code), Name(""), Zone("walk"), coordinate(stopCords), isVisited(false), walkNeighbours({}), lineNeighbours({}){}
+Stop::Stop(std::string code, Coordinate stopCords): Code(code), Name(""), Zone("walk"), zoneId(NO_ZONE), coordinate(stopCords), isVisited(false){}
 
 /**
  * Constructor
  */
-Stop::Stop() {}
+Stop::Stop(): zoneId(NO_ZONE), isVisited(false) {}
 
 /**
  * This method returns the code of the bus stop
@@ -50,10 +53,26 @@ const std::string &Stop::getName() const {
  * This method return the zone the bus stop is located at
  * @return This returns a string that is the zone of the bus stop
  */
-const std::string Stop::getZone() const {
+const std::string &Stop::getZone() const {
     return Zone;
 }
 
+/**
+ * This method returns the interned zone of the bus stop
+ * @return This returns the number of the zone, or NO_ZONE if the zone was not interned
+ */
+unsigned Stop::getZoneId() const {
+    return zoneId;
+}
+
+/**
+ * This method sets the interned zone of the bus stop
+ * @param zoneId This is the number of the zone
+ */
+void Stop::setZoneId(unsigned zoneId) {
+    this->zoneId = zoneId;
+}
+
 /**
  * This method return the coordinates the bus stop is located at
  * @return This returns the coordinate (coordinate is an object) of the bus stop
@@ -73,49 +92,10 @@ std::ostream &operator<<(std::ostream &os, const Stop &stop) {
  * @param stop2 This is the second bus stop to calculate te distance
  * @return The return is a double with the distance between the two stops in meters
  */
-double Stop::distance(Stop stop2) {
+double Stop::distance(const Stop& stop2) const {
     return coordinate.haversine(stop2.coordinate);
 }
 
-/**
- * This method adds a new neighbour to the bus stop, where we can get to by taking a bus
- * @param myNewNeighbours This is the bus stop we are going to add as neighbour
- */
-void Stop::addLineNeighbour(std::tuple<double, Stop &, std::string> myNewNeighbours) {
-    this->lineNeighbours.push_back(myNewNeighbours);
-}
-
-/**
- * This method adds a new neighbour to the bus stop, where we can get to by walking
- * @param myNewNeighbours This is the bus stop we are going to add as neighbour
- */
-void Stop::addWalkNeighbour(std::tuple<double, Stop &, std::string> myNewNeighbours) {
-    this->walkNeighbours.push_back(myNewNeighbours);
-}
-
-/**
- * This method clears all the walking neighbours, is used before calculating it again depending on the user preferences
- */
-void Stop::clearWalkNeighbours() {
-    walkNeighbours.erase(walkNeighbours.begin(), walkNeighbours.end());
-}
-
-/**
- * This method returns the neighbours we can get by taking a bus
- * @return The return is a list of the neighbour and its necessary info
- */
-const std::list<std::tuple<double, Stop &, std::string>> &Stop::getLineNeighbours() const {
-    return lineNeighbours;
-}
-
-/**
- * This method returns the neighbours we can get by walking
- * @return The return is a list of the neighbour and its necessary info
- */
-const std::list<std::tuple<double, Stop &, std::string>> &Stop::getWalkNeighbours() const {
-    return walkNeighbours;
-}
-
 /**
  * This method sets the bus stop as visited
  */
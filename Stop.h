@@ -11,9 +11,6 @@
 #define AEDAGRAFOS_STOP_H
 
 #include <ostream>
-#include <list>
-#include <tuple>
-#include <set>
 #include "string"
 #include "Coordinate.h"
 
@@ -22,13 +19,15 @@
  * @param Code This is the identifying code of the bus stop
  * @param Name This is the name of the bus stop
  * @param Zone This is the zone of the city where the bus stop is located at
+ * @param zoneId This is the zone interned to a small number when the stops are read (NO_ZONE if it was not interned)
  * @param coordinate This is the coordinates that the bus stop is located at
- * @param lineNeighbours This is the neighbours (edges) of the bus stop where we can go to by taking a bus
- * @param walkNeighbours This is the neighbours (edges) of the bus stop where we can get to by walking
  * @param isVisited This is used to during processing to mark if this bus stops was already calculated (visited) in our algorithm or not
  */
 class Stop {
 public:
+    static const unsigned NO_ZONE = 0xFFFFFFFF;
+    static const unsigned MAX_ZONES = 64; //the number of zones a set of zones of a search can tell apart
+
     void reset();
     //when it is a random stop
     Stop(std::string code, Coordinate stopCords);
@@ -37,17 +36,7 @@ public:
 
     friend std::ostream &operator<<(std::ostream &os, const Stop &stop);
 
-    double distance(Stop stop2);
-
-    void addLineNeighbour(std::tuple<double, Stop&, std::string> myNewNeighbours);
-
-    void addWalkNeighbour(std::tuple<double, Stop&, std::string> myNewNeighbours);
-
-    void clearWalkNeighbours();
-
-    const std::list<std::tuple<double, Stop &, std::string>> &getLineNeighbours() const;
-
-    const std::list<std::tuple<double, Stop &, std::string>> &getWalkNeighbours() const;
+    double distance(const Stop& stop2) const;
 
 
 
@@ -67,7 +56,11 @@ public:
 
     const std::string &getName() const;
 
-    const std::string getZone() const;
+    const std::string &getZone() const;
+
+    unsigned getZoneId() const;
+
+    void setZoneId(unsigned zoneId);
 
     Coordinate getCoordinate() const;
 
@@ -89,10 +82,8 @@ private:
     std::string Code;
     std::string Name;
     std::string Zone;
+    unsigned zoneId;
     Coordinate coordinate;
-    //in tuple, first distance, after stop neighbours and last the line code.
-    std::list<std::tuple<double, Stop&, std::string>> lineNeighbours;
-    std::list<std::tuple<double, Stop&, std::string>> walkNeighbours;
     bool isVisited;
 
 };
@@ -0,0 +1,471 @@
+/**
+ * @file Timetable.cpp
+ * @brief This file contains the implementation of the functions in Timetable.h (the timetable and the connection scan)
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Timetable.h"
+
+const unsigned Timetable::NO_TIME;
+const unsigned Timetable::NO_CONNECTION;
+
+/**
+ * This is the speed (in meters per second) of a person walking between stops
+ */
+static const double WALKING_SPEED = 1.2;
+
+/**
+ * This is the new index of a stop that was removed (the NO_STOP of the graph)
+ */
+static const unsigned REMOVED_STOP = std::numeric_limits<unsigned>::max();
+
+/**
+ * Constructor (a timetable without trips)
+ */
+Timetable::Timetable() : routeOffsets(1, 0), tripOffsets(1, 0) {}
+
+/**
+ * Constructor, it lays out the routes and the trips one after the other and builds the sorted connections
+ * @param routes This is the index of the stops of every route, in the order the bus goes through them
+ * @param routeServices This is the bitmask of the service periods every route runs in
+ * @param routeTrips This is the trips of every route, for every trip the time it leaves every stop of the route (a trip
+ * with another number of times is ignored)
+ */
+Timetable::Timetable(const std::vector<std::vector<unsigned>> &routes, const std::vector<unsigned char> &routeServices,
+                     const std::vector<std::vector<std::vector<unsigned>>> &routeTrips) : routeOffsets(1, 0),
+                                                                                          routeServices(routeServices) {
+    for (unsigned route = 0; route < routes.size(); ++route) {
+        routeStops.insert(routeStops.end(), routes[route].begin(), routes[route].end());
+        routeOffsets.push_back(routeStops.size());
+        for (const auto &times: routeTrips[route]) {
+            if (times.size() == routes[route].size()) {
+                tripRoutes.push_back(route);
+                tripTimes.insert(tripTimes.end(), times.begin(), times.end());
+            }
+        }
+    }
+    buildConnections();
+}
+
+/**
+ * This method builds the position of the times of every trip and the connections of the trips, sorted by the time they
+ * leave (and then by the time they arrive, so the connections of a trip that take no time stay in the order of the
+ * route)
+ */
+void Timetable::buildConnections() {
+    tripOffsets.assign(1, 0);
+    connections.clear();
+    for (unsigned trip = 0; trip < tripRoutes.size(); ++trip) {
+        unsigned route = tripRoutes[trip];
+        unsigned first = routeOffsets[route];
+        unsigned length = routeOffsets[route + 1] - first;
+        unsigned times = tripOffsets.back();
+        for (unsigned position = 0; position + 1 < length; ++position) {
+            connections.push_back({routeStops[first + position], routeStops[first + position + 1],
+                                   tripTimes[times + position], tripTimes[times + position + 1], trip, position,
+                                   routeServices[route]});
+        }
+        tripOffsets.push_back(times + length);
+    }
+    std::sort(connections.begin(), connections.end(), [](const Connection &a, const Connection &b) {
+        if (a.departureTime != b.departureTime) {
+            return a.departureTime < b.departureTime;
+        }
+        if (a.arrivalTime != b.arrivalTime) {
+            return a.arrivalTime < b.arrivalTime;
+        }
+        return a.trip < b.trip || (a.trip == b.trip && a.position < b.position);
+    });
+}
+
+/**
+ * This method gets the number of trips of the timetable
+ * @return The return is the number of trips
+ */
+unsigned Timetable::getNumberTrips() const {
+    return tripRoutes.size();
+}
+
+/**
+ * This method gets the number of connections of the timetable
+ * @return The return is the number of connections (0 if no line has a timetable)
+ */
+unsigned Timetable::getNumberConnections() const {
+    return connections.size();
+}
+
+/**
+ * This method builds the timetable without some stops, a route is split where a stop was removed (like the routes of
+ * the round based router) and every trip is split with it
+ * @param newIndex This is the index every stop has after the removal, or NO_STOP if it was removed
+ * @return The return is the timetable over the stops that are left
+ */
+Timetable Timetable::withoutStops(const std::vector<unsigned> &newIndex) const {
+    std::vector<std::vector<unsigned>> oldTrips(routeOffsets.size() - 1);
+    for (unsigned trip = 0; trip < tripRoutes.size(); ++trip) {
+        oldTrips[tripRoutes[trip]].push_back(trip);
+    }
+    std::vector<std::vector<unsigned>> routes;
+    std::vector<unsigned char> services;
+    std::vector<std::vector<std::vector<unsigned>>> trips;
+    for (unsigned route = 0; route + 1 < routeOffsets.size(); ++route) {
+        unsigned first = routeOffsets[route];
+        unsigned length = routeOffsets[route + 1] - first;
+        unsigned partStart = 0;
+        for (unsigned position = 0; position <= length; ++position) {
+            if (position < length && newIndex[routeStops[first + position]] != REMOVED_STOP) {
+                continue;
+            }
+            if (position - partStart >= 2) {
+                routes.emplace_back();
+                for (unsigned p = partStart; p < position; ++p) {
+                    routes.back().push_back(newIndex[routeStops[first + p]]);
+                }
+                services.push_back(routeServices[route]);
+                trips.emplace_back();
+                for (unsigned trip: oldTrips[route]) {
+                    trips.back().emplace_back(tripTimes.begin() + tripOffsets[trip] + partStart,
+                                              tripTimes.begin() + tripOffsets[trip] + position);
+                }
+            }
+            partStart = position + 1;
+        }
+    }
+    return Timetable(routes, services, trips);
+}
+
+/**
+ * This method writes the routes and the trips to a snapshot (the connections are built again when it is read)
+ * @param snapshot This is the snapshot being written
+ */
+void Timetable::save(Snapshot &snapshot) const {
+    snapshot.putArray(routeOffsets);
+    snapshot.putArray(routeStops);
+    snapshot.putArray(routeServices);
+    snapshot.putArray(tripRoutes);
+    snapshot.putArray(tripTimes);
+}
+
+/**
+ * This method reads the routes and the trips from a snapshot written by save and builds the connections, the timetable
+ * is only replaced if every route goes through the stops given and every trip has one time (not decreasing) for every
+ * stop of its route
+ * @param snapshot This is the mapped snapshot
+ * @param nStops This is the number of stops of the graph
+ * @return The return is true if the timetable was read
+ */
+bool Timetable::load(Snapshot &snapshot, unsigned nStops) {
+    Timetable read;
+    if (!snapshot.getArray(read.routeOffsets) || !snapshot.getArray(read.routeStops) ||
+        !snapshot.getArray(read.routeServices) || !snapshot.getArray(read.tripRoutes) ||
+        !snapshot.getArray(read.tripTimes) || read.routeOffsets.empty() || read.routeOffsets.front() != 0 ||
+        read.routeOffsets.back() != read.routeStops.size() ||
+        read.routeServices.size() + 1 != read.routeOffsets.size()) {
+        return false;
+    }
+    for (unsigned route = 0; route + 1 < read.routeOffsets.size(); ++route) {
+        if (read.routeOffsets[route] > read.routeOffsets[route + 1]) {
+            return false;
+        }
+    }
+    for (unsigned stop: read.routeStops) {
+        if (stop >= nStops) {
+            return false;
+        }
+    }
+    size_t nTimes = 0;
+    for (unsigned trip = 0; trip < read.tripRoutes.size(); ++trip) {
+        unsigned route = read.tripRoutes[trip];
+        if (route + 1 >= read.routeOffsets.size()) {
+            return false;
+        }
+        unsigned length = read.routeOffsets[route + 1] - read.routeOffsets[route];
+        if (length > read.tripTimes.size() - nTimes) {
+            return false;
+        }
+        for (unsigned position = 1; position < length; ++position) {
+            if (read.tripTimes[nTimes + position] < read.tripTimes[nTimes + position - 1]) {
+                return false;
+            }
+        }
+        nTimes += length;
+    }
+    if (nTimes != read.tripTimes.size()) {
+        return false;
+    }
+    read.buildConnections();
+    *this = std::move(read);
+    return true;
+}
+
+/**
+ * This method gets the time it takes to walk a distance
+ * @param distance This is the distance in meters
+ * @return The return is the time in seconds (rounded up)
+ */
+unsigned Timetable::walkingTime(double distance) {
+    return (unsigned) std::ceil(distance / WALKING_SPEED);
+}
+
+/**
+ * This method finds the earliest arrival at a set of targets leaving a set of sources at a time, every source and
+ * target has an extra distance (the walk from a place that is not a stop). The connections are scanned from the time
+ * of departure until they leave after the best arrival found. A transfer can walk one walking edge from the stop
+ * where a bus was left (a bus can be taken at the time the stop is reached), so every stop keeps two arrivals: the
+ * earliest one and the earliest one that did not end walking, which is where a walk can start
+ * @param sources This is the stops where the path may start and the distance to get to them
+ * @param targets This is the stops where the path may end and the distance from them to the destination
+ * @param departureTime This is the time of departure from the sources (in seconds after midnight)
+ * @param services This is the bitmask of the service periods of the trips that can be taken
+ * @param walkEdges This is the walking edges between the stops, sorted by distance for every stop
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @param workspace This is the memory the search works on
+ * @param path This is where the stops of the path are stored, empty if there is no path
+ * @return The return is the earliest time of arrival at the destination, NO_TIME if there is no path
+ */
+unsigned Timetable::earliestArrival(const std::vector<std::pair<unsigned, double>> &sources,
+                                    const std::vector<std::pair<unsigned, double>> &targets, unsigned departureTime,
+                                    unsigned char services, const Adjacency &walkEdges, double walkingDistance,
+                                    SearchWorkspace &workspace, std::vector<unsigned> &path) const {
+    path.clear();
+    //the arrival at the stop s is in the position s, and the one that did not end walking in nStops + s
+    unsigned nStops = walkEdges.getNumberNodes();
+    std::vector<unsigned> &arrival = workspace.arrivalTime;
+    std::vector<SearchWorkspace::ConnectionStep> &steps = workspace.connectionSteps;
+    arrival.assign(2 * nStops, NO_TIME);
+    steps.assign(2 * nStops, {NO_CONNECTION, NO_CONNECTION, NO_CONNECTION});
+    workspace.tripBoarding.assign(tripRoutes.size(), NO_CONNECTION);
+    const std::vector<unsigned> &offsets = walkEdges.getOffsets();
+    const std::vector<unsigned> &walkTargets = walkEdges.getTargets();
+    const std::vector<double> &weights = walkEdges.getWeights();
+
+    unsigned bestTarget = NO_TIME, bestStop = NO_CONNECTION;
+    //it returns true if the arrival that did not end walking was improved
+    auto reach = [&](unsigned stop, unsigned time, const SearchWorkspace::ConnectionStep &step, bool walking) {
+        bool improved = false;
+        if (!walking && time < arrival[nStops + stop]) {
+            arrival[nStops + stop] = time;
+            steps[nStops + stop] = step;
+            improved = true;
+        }
+        if (time < arrival[stop]) {
+            arrival[stop] = time;
+            steps[stop] = step;
+            for (const auto &target: targets) {
+                if (target.first == stop && time + walkingTime(target.second) < bestTarget) {
+                    bestTarget = time + walkingTime(target.second);
+                    bestStop = stop;
+                }
+            }
+        }
+        return improved;
+    };
+    auto walkFrom = [&](unsigned stop) {
+        for (unsigned e = offsets[stop]; e < offsets[stop + 1] && weights[e] <= walkingDistance; ++e) {
+            reach(walkTargets[e], arrival[nStops + stop] + walkingTime(weights[e]),
+                  {stop, NO_CONNECTION, NO_CONNECTION}, true);
+        }
+    };
+
+    for (const auto &source: sources) {
+        reach(source.first, departureTime + walkingTime(source.second), {NO_CONNECTION, NO_CONNECTION, NO_CONNECTION},
+              false);
+    }
+    for (const auto &source: sources) {
+        walkFrom(source.first);
+    }
+
+    auto first = std::lower_bound(connections.begin(), connections.end(), departureTime,
+                                  [](const Connection &connection, unsigned time) {
+                                      return connection.departureTime < time;
+                                  });
+    for (unsigned c = first - connections.begin(); c < connections.size(); ++c) {
+        const Connection &connection = connections[c];
+        if (connection.departureTime >= bestTarget) {
+            break; //it can not arrive before the best arrival found
+        }
+        if (!(connection.services & services)) {
+            continue;
+        }
+        unsigned &boarding = workspace.tripBoarding[connection.trip];
+        if (boarding == NO_CONNECTION) {
+            if (arrival[connection.departureStop] > connection.departureTime) {
+                continue;
+            }
+            boarding = c;
+        }
+        if (reach(connection.arrivalStop, connection.arrivalTime, {connections[boarding].departureStop, boarding, c},
+                  false)) {
+            walkFrom(connection.arrivalStop);
+        }
+    }
+
+    if (bestStop == NO_CONNECTION) {
+        return NO_TIME;
+    }
+    //follow the steps back to a source, a bus step goes through every stop of the route between the two connections
+    //and a walk starts at an arrival that did not end walking
+    unsigned step = bestStop;
+    path.push_back(bestStop);
+    while (steps[step].previous != NO_CONNECTION) {
+        const SearchWorkspace::ConnectionStep &current = steps[step];
+        if (current.boarding == NO_CONNECTION) {
+            path.push_back(current.previous);
+            step = nStops + current.previous;
+        }
+        else {
+            const Connection &boarding = connections[current.boarding];
+            unsigned first = routeOffsets[tripRoutes[boarding.trip]];
+            for (unsigned position = connections[current.alighting].position + 1; position-- > boarding.position;) {
+                path.push_back(routeStops[first + position]);
+            }
+            step = current.previous;
+        }
+    }
+    std::reverse(path.begin(), path.end());
+    return bestTarget;
+}
+
+/**
+ * This method finds every best option to go from a set of sources to a set of targets leaving in a time window (the
+ * pairs of departure and arrival times that no other pair beats by leaving later and arriving earlier), with the same
+ * walks as earliestArrival. An option must arrive before the earliest arrival leaving after the window, so one earliest
+ * arrival search finds where the scan starts. The connections are then scanned once from there back to the start of the
+ * window; the best arrival of a connection is the best of staying on its trip, walking from its stop to the
+ * destination or taking the best departure (found before, they leave later) of its stop or of a stop one walking edge
+ * away. Every stop keeps its departures that are not beaten, which are the options of the stops the start walks to
+ * @param sources This is the stops where the path may start and the distance to get to them
+ * @param targets This is the stops where the path may end and the distance from them to the destination
+ * @param earliest This is the first time of departure of the window (in seconds after midnight)
+ * @param latest This is the last time of departure of the window
+ * @param services This is the bitmask of the service periods of the trips that can be taken
+ * @param walkEdges This is the walking edges between the stops, sorted by distance for every stop
+ * @param walkingDistance This is the maximum distance to walk between stops
+ * @param workspace This is the memory the search works on
+ * @return The return is the departure and arrival times of every best option, from the earliest departure
+ */
+std::vector<std::pair<unsigned, unsigned>> Timetable::profile(const std::vector<std::pair<unsigned, double>> &sources,
+                                                              const std::vector<std::pair<unsigned, double>> &targets,
+                                                              unsigned earliest, unsigned latest, unsigned char services,
+                                                              const Adjacency &walkEdges, double walkingDistance,
+                                                              SearchWorkspace &workspace) const {
+    std::vector<unsigned> path;
+    unsigned afterWindow = latest == NO_TIME ? NO_TIME : earliestArrival(sources, targets, latest + 1, services, walkEdges,
+                                                                         walkingDistance, workspace, path);
+
+    //the walk from the stop s to the destination is in the position s, and the walk from the start in nStops + s
+    unsigned nStops = walkEdges.getNumberNodes();
+    std::vector<unsigned> &walkTime = workspace.arrivalTime;
+    walkTime.assign(2 * nStops, NO_TIME);
+    workspace.tripArrival.assign(tripRoutes.size(), NO_TIME);
+    workspace.profiles.resize(std::max<size_t>(workspace.profiles.size(), nStops));
+    for (unsigned stop = 0; stop < nStops; ++stop) {
+        workspace.profiles[stop].clear();
+    }
+    const std::vector<unsigned> &offsets = walkEdges.getOffsets();
+    const std::vector<unsigned> &walkTargets = walkEdges.getTargets();
+    const std::vector<double> &weights = walkEdges.getWeights();
+
+    //a walk to the destination can go through one walking edge before the last walk, so every stop looks for the
+    //targets among its walking edges (their walk is kept apart while that is done)
+    for (const auto &target: targets) {
+        walkTime[nStops + target.first] = std::min(walkTime[nStops + target.first], walkingTime(target.second));
+    }
+    for (unsigned stop = 0; stop < nStops; ++stop) {
+        walkTime[stop] = walkTime[nStops + stop];
+        for (unsigned e = offsets[stop]; e < offsets[stop + 1] && weights[e] <= walkingDistance; ++e) {
+            if (walkTime[nStops + walkTargets[e]] != NO_TIME) {
+                walkTime[stop] = std::min(walkTime[stop], walkingTime(weights[e]) + walkTime[nStops + walkTargets[e]]);
+            }
+        }
+    }
+    //a walk from the start can also go through one walking edge after the first walk
+    std::fill(walkTime.begin() + nStops, walkTime.end(), NO_TIME);
+    for (const auto &source: sources) {
+        unsigned time = walkingTime(source.second);
+        walkTime[nStops + source.first] = std::min(walkTime[nStops + source.first], time);
+        for (unsigned e = offsets[source.first]; e < offsets[source.first + 1] && weights[e] <= walkingDistance; ++e) {
+            unsigned &neighbour = walkTime[nStops + walkTargets[e]];
+            neighbour = std::min(neighbour, time + walkingTime(weights[e]));
+        }
+    }
+
+    //the departures of a stop go from the latest to the earliest and their arrivals too, the best one leaving at a
+    //time or later is the last one that does not leave before it
+    auto bestDeparture = [&](unsigned stop, unsigned time) {
+        const std::vector<std::pair<unsigned, unsigned>> &departures = workspace.profiles[stop];
+        auto after = std::partition_point(departures.begin(), departures.end(),
+                                          [time](const std::pair<unsigned, unsigned> &departure) {
+                                              return departure.first >= time;
+                                          });
+        return after == departures.begin() ? NO_TIME : (after - 1)->second;
+    };
+
+    auto leavesBefore = [](const Connection &connection, unsigned time) {
+        return connection.departureTime < time;
+    };
+    auto first = std::lower_bound(connections.begin(), connections.end(), earliest, leavesBefore);
+    auto last = std::lower_bound(first, connections.end(), afterWindow, leavesBefore);
+    for (unsigned c = last - connections.begin(); c-- > (unsigned) (first - connections.begin());) {
+        const Connection &connection = connections[c];
+        if (!(connection.services & services)) {
+            continue;
+        }
+        unsigned stop = connection.arrivalStop;
+        unsigned arrival = workspace.tripArrival[connection.trip];
+        if (walkTime[stop] != NO_TIME) {
+            arrival = std::min(arrival, connection.arrivalTime + walkTime[stop]);
+        }
+        arrival = std::min(arrival, bestDeparture(stop, connection.arrivalTime));
+        for (unsigned e = offsets[stop]; e < offsets[stop + 1] && weights[e] <= walkingDistance; ++e) {
+            arrival = std::min(arrival, bestDeparture(walkTargets[e], connection.arrivalTime + walkingTime(weights[e])));
+        }
+        if (arrival == NO_TIME) {
+            continue;
+        }
+        workspace.tripArrival[connection.trip] = arrival;
+
+        //the departure is kept if it arrives before every departure found before, which leave later
+        std::vector<std::pair<unsigned, unsigned>> &departures = workspace.profiles[connection.departureStop];
+        if (departures.empty() || arrival < departures.back().second) {
+            if (!departures.empty() && departures.back().first == connection.departureTime) {
+                departures.back().second = arrival;
+            }
+            else {
+                departures.emplace_back(connection.departureTime, arrival);
+            }
+        }
+    }
+
+    //the options of the start are the departures of the stops it walks to, leaving earlier by the walk
+    std::vector<std::pair<unsigned, unsigned>> options;
+    for (unsigned stop = 0; stop < nStops; ++stop) {
+        unsigned walk = walkTime[nStops + stop];
+        if (walk == NO_TIME) {
+            continue;
+        }
+        for (const auto &departure: workspace.profiles[stop]) {
+            if (departure.first >= walk && departure.first - walk >= earliest && departure.first - walk <= latest) {
+                options.emplace_back(departure.first - walk, departure.second);
+            }
+        }
+    }
+    std::sort(options.begin(), options.end(), [](const std::pair<unsigned, unsigned> &a,
+                                                 const std::pair<unsigned, unsigned> &b) {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    });
+    std::vector<std::pair<unsigned, unsigned>> best;
+    for (const auto &option: options) {
+        if (option.second < (best.empty() ? afterWindow : best.back().second)) {
+            best.push_back(option);
+        }
+    }
+    std::reverse(best.begin(), best.end());
+    return best;
+}
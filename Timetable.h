@@ -0,0 +1,101 @@
+/**
+ * @file Timetable.h
+ * @brief This file contains the implementation of the timetable of the bus lines and of its connection scan router
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#ifndef AEDAGRAFOS_TIMETABLE_H
+#define AEDAGRAFOS_TIMETABLE_H
+
+#include <vector>
+#include <utility>
+#include "Adjacency.h"
+#include "Snapshot.h"
+#include "SearchWorkspace.h"
+
+/**
+ * This is the timetable of the bus lines and a router that answers when is the earliest arrival leaving at a time
+ * (Connection Scan Algorithm). Every trip of a route is split in connections, a bus leaving a stop at a time and
+ * arriving at the next stop at a later time, and all the connections are kept in one array sorted by the time they
+ * leave. A search scans that array once from the time of departure: a connection is taken if its trip was already
+ * taken or if its stop was reached before it leaves, so there is no priority queue and the memory is read in order.
+ * Scanning the same array backwards gives every best departure over a time window in one pass (the profile search).
+ * The times are in seconds after the midnight of the day of service
+ * @param routeOffsets This is the position in routeStops of the first stop of every route
+ * @param routeStops This is the stops of every route, in the order the bus goes through them
+ * @param routeServices This is the bitmask of the service periods every route runs in
+ * @param tripRoutes This is the route of every trip
+ * @param tripOffsets This is the position in tripTimes of the first time of every trip
+ * @param tripTimes This is the time the bus of every trip leaves every stop of its route
+ * @param connections This is the connections of every trip, sorted by the time they leave
+ */
+class Timetable {
+public:
+    static const unsigned NO_TIME = 0xFFFFFFFF;
+    static const unsigned NO_CONNECTION = 0xFFFFFFFF;
+
+    /**
+     * This is a bus of a trip going from a stop of its route to the next one
+     * @param departureStop This is the stop the bus leaves
+     * @param arrivalStop This is the next stop of the route
+     * @param departureTime This is the time the bus leaves departureStop
+     * @param arrivalTime This is the time the bus gets to arrivalStop
+     * @param trip This is the trip of the bus
+     * @param position This is the position of departureStop in the route of the trip
+     * @param services This is the bitmask of the service periods of the route of the trip
+     */
+    struct Connection {
+        unsigned departureStop;
+        unsigned arrivalStop;
+        unsigned departureTime;
+        unsigned arrivalTime;
+        unsigned trip;
+        unsigned position;
+        unsigned char services;
+    };
+
+    Timetable();
+
+    Timetable(const std::vector<std::vector<unsigned>> &routes, const std::vector<unsigned char> &routeServices,
+              const std::vector<std::vector<std::vector<unsigned>>> &routeTrips);
+
+    unsigned getNumberTrips() const;
+
+    unsigned getNumberConnections() const;
+
+    Timetable withoutStops(const std::vector<unsigned> &newIndex) const;
+
+    void save(Snapshot &snapshot) const;
+
+    bool load(Snapshot &snapshot, unsigned nStops);
+
+    static unsigned walkingTime(double distance);
+
+    unsigned earliestArrival(const std::vector<std::pair<unsigned, double>> &sources,
+                             const std::vector<std::pair<unsigned, double>> &targets, unsigned departureTime,
+                             unsigned char services, const Adjacency &walkEdges, double walkingDistance,
+                             SearchWorkspace &workspace, std::vector<unsigned> &path) const;
+
+    std::vector<std::pair<unsigned, unsigned>> profile(const std::vector<std::pair<unsigned, double>> &sources,
+                                                       const std::vector<std::pair<unsigned, double>> &targets,
+                                                       unsigned earliest, unsigned latest, unsigned char services,
+                                                       const Adjacency &walkEdges, double walkingDistance,
+                                                       SearchWorkspace &workspace) const;
+
+private:
+    std::vector<unsigned> routeOffsets;
+    std::vector<unsigned> routeStops;
+    std::vector<unsigned char> routeServices;
+    std::vector<unsigned> tripRoutes;
+    std::vector<unsigned> tripOffsets;
+    std::vector<unsigned> tripTimes;
+    std::vector<Connection> connections;
+
+    void buildConnections();
+};
+
+
+#endif //AEDAGRAFOS_TIMETABLE_H
@@ -0,0 +1,206 @@
+/**
+ * @file TimetableTest.cpp
+ * @brief This file contains the checks of the earliest arrival and profile searches over the timetables of the lines
+ *
+ * @author Marcos William Ferreira Pinto, Matias Freitas Guimarães, Tiago Ribeiro
+ *
+ * @date 29/1/2022
+ */
+
+#include <iostream>
+#include <cmath>
+#include "Graph.h"
+
+/**
+ * This is the number of meters in a degree of latitude (and of longitude on the equator), used to place the stops
+ */
+static const double METERS_PER_DEGREE = 6371000 * M_PI / 180.0;
+
+/**
+ * This is the longest walk of the checks, the walking edges are precomputed up to it
+ */
+static const double WALKING_DISTANCE = 100;
+
+/**
+ * These are the time window of the profile checks and the step of the times of departure they are compared at
+ */
+static const unsigned PROFILE_START = 7 * 3600 + 30 * 60;
+static const unsigned PROFILE_END = 9 * 3600;
+static const unsigned PROFILE_STEP = 10;
+
+/**
+ * This method makes a place some meters away from the origin of the checks (on the equator, where a degree of
+ * longitude and of latitude have the same length)
+ * @param code This is the code of the place
+ * @param east This is the distance to the east in meters
+ * @return The return is the place
+ */
+static Stop place(const std::string &code, double east) {
+    return Stop(code, code, "Z1", Coordinate(0, east / METERS_PER_DEGREE));
+}
+
+/**
+ * This method gets a time of the day
+ * @param hours This is the hours
+ * @param minutes This is the minutes
+ * @return The return is the time in seconds after midnight
+ */
+static unsigned at(unsigned hours, unsigned minutes) {
+    return hours * 3600 + minutes * 60;
+}
+
+/**
+ * This method makes a line with its trips
+ * @param stops This is the codes of the stops of the line
+ * @param code This is the code of the line
+ * @param trips This is the time the bus of every trip leaves every stop
+ * @return The return is the line
+ */
+static Line line(const std::vector<std::string> &stops, const std::string &code,
+                 const std::vector<std::vector<unsigned>> &trips) {
+    Line line(stops, code, code, 0);
+    for (const auto &trip: trips) {
+        line.addTrip(trip);
+    }
+    return line;
+}
+
+/**
+ * This method builds the network of the checks: L1 goes A -> B -> C, L2 goes from D (60 m from C) to E and L3 goes
+ * straight from A to E, slower than L1 and L2 with the walk between C and D
+ * @return The return is the graph, with the walking edges up to WALKING_DISTANCE
+ */
+static Graph network() {
+    std::set<Stop> stops = {place("A", 0), place("B", 1000), place("C", 2000), place("D", 2060), place("E", 3060)};
+    std::set<Line> lines = {
+            line({"A", "B", "C"}, "L1", {{at(8, 0), at(8, 5), at(8, 10)}, {at(8, 30), at(8, 35), at(8, 40)}}),
+            line({"D", "E"}, "L2", {{at(8, 11), at(8, 20)}, {at(8, 45), at(8, 55)}}),
+            line({"A", "E"}, "L3", {{at(8, 2), at(8, 50)}})};
+    Graph graph(stops, lines, true, 1);
+    graph.precomputeWalkEdges(WALKING_DISTANCE, 1);
+    return graph;
+}
+
+/**
+ * This method writes the codes of the stops of a path
+ * @param path This is the path
+ * @return The return is the codes joined by spaces
+ */
+static std::string codes(const std::list<Stop> &path) {
+    std::string text;
+    for (const auto &stop: path) {
+        text += (text.empty() ? "" : " ") + stop.getCode();
+    }
+    return text;
+}
+
+/**
+ * This method checks one earliest arrival search
+ * @param graph This is the graph
+ * @param start This is the place the search leaves from
+ * @param dest This is the place the search goes to
+ * @param departure This is the time of departure
+ * @param walkingDistance This is the maximum distance to walk
+ * @param expectedArrival This is the time the search must arrive at
+ * @param expectedPath This is the codes of the stops of the path the search must find
+ * @return The return is true if the search found them
+ */
+static bool arrives(const Graph &graph, const Stop &start, const Stop &dest, unsigned departure,
+                    double walkingDistance, unsigned expectedArrival, const std::string &expectedPath) {
+    SearchWorkspace workspace;
+    unsigned arrival;
+    std::list<Stop> path = graph.earliestArrival(start, dest, departure, walkingDistance, Line::ALL_SERVICES,
+                                                 workspace, arrival);
+    if (arrival != expectedArrival || codes(path) != expectedPath) {
+        std::cout << start.getCode() << " -> " << dest.getCode() << " leaving at " << departure << " walking "
+                  << walkingDistance << " m: arrived at " << arrival << " by \"" << codes(path) << "\", expected "
+                  << expectedArrival << " by \"" << expectedPath << "\"" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * This checks the earliest arrival searches: a bus taken at the time it leaves, a missed bus, a transfer that walks
+ * from C to D, the same transfer when the walk is too long, and a place that is not a stop
+ * @param graph This is the graph of the checks
+ * @return The return is true if every search arrives when it should
+ */
+static bool earliestArrivals(const Graph &graph) {
+    Stop a = place("A", 0), c = place("C", 2000), e = place("E", 3060);
+    //50 m before A, 42 s of walking at the walking speed of the timetable
+    Stop origin("ORIGIN", place("O", -50).getCoordinate());
+    bool passed = arrives(graph, a, c, at(8, 0), WALKING_DISTANCE, at(8, 10), "A B C");
+    passed &= arrives(graph, a, c, at(8, 0) + 1, WALKING_DISTANCE, at(8, 40), "A B C");
+    passed &= arrives(graph, a, e, at(7, 50), WALKING_DISTANCE, at(8, 20), "A B C D E");
+    passed &= arrives(graph, a, e, at(7, 50), 50, at(8, 50), "A E");
+    passed &= arrives(graph, a, e, at(8, 1), WALKING_DISTANCE, at(8, 50), "A E");
+    passed &= arrives(graph, a, e, at(8, 3), WALKING_DISTANCE, at(8, 55), "A B C D E");
+    passed &= arrives(graph, origin, c, at(7, 59), WALKING_DISTANCE, at(8, 10), "ORIGIN A B C");
+    passed &= arrives(graph, origin, c, at(7, 59) + 30, WALKING_DISTANCE, at(8, 40), "ORIGIN A B C");
+    passed &= arrives(graph, a, e, at(8, 31), WALKING_DISTANCE, Timetable::NO_TIME, "");
+    return passed;
+}
+
+/**
+ * This method checks the options of a profile search against the earliest arrival searches: leaving at any time of
+ * the window, the earliest arrival is the one of the first option that does not leave before
+ * @param graph This is the graph
+ * @param start This is the place the searches leave from
+ * @param dest This is the place the searches go to
+ * @param walkingDistance This is the maximum distance to walk
+ * @return The return is true if the profile gives the same arrivals as the earliest arrival searches
+ */
+static bool sameAsEarliestArrival(const Graph &graph, const Stop &start, const Stop &dest, double walkingDistance) {
+    SearchWorkspace workspace;
+    std::vector<std::pair<unsigned, unsigned>> options = graph.departureProfile(start, dest, PROFILE_START, PROFILE_END,
+                                                                                walkingDistance, Line::ALL_SERVICES,
+                                                                                workspace);
+    if (options.empty()) {
+        std::cout << start.getCode() << " -> " << dest.getCode() << " walking " << walkingDistance
+                  << " m: the profile has no options" << std::endl;
+        return false;
+    }
+    bool passed = true;
+    for (unsigned time = PROFILE_START; time <= PROFILE_END; time += PROFILE_STEP) {
+        unsigned expected = Timetable::NO_TIME;
+        for (const auto &option: options) {
+            if (option.first >= time) {
+                expected = option.second;
+                break;
+            }
+        }
+        unsigned arrival;
+        graph.earliestArrival(start, dest, time, walkingDistance, Line::ALL_SERVICES, workspace, arrival);
+        if (arrival != expected) {
+            std::cout << start.getCode() << " -> " << dest.getCode() << " leaving at " << time << " walking "
+                      << walkingDistance << " m: the profile arrives at " << expected << ", the earliest arrival at "
+                      << arrival << std::endl;
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+/**
+ * This checks the profile searches of the network between places with several options
+ * @param graph This is the graph of the checks
+ * @return The return is true if every profile matches the earliest arrival searches
+ */
+static bool profiles(const Graph &graph) {
+    Stop a = place("A", 0), c = place("C", 2000), e = place("E", 3060);
+    Stop origin("ORIGIN", place("O", -50).getCoordinate());
+    bool passed = sameAsEarliestArrival(graph, a, e, WALKING_DISTANCE);
+    passed &= sameAsEarliestArrival(graph, a, e, 50);
+    passed &= sameAsEarliestArrival(graph, a, c, WALKING_DISTANCE);
+    passed &= sameAsEarliestArrival(graph, origin, e, WALKING_DISTANCE);
+    return passed;
+}
+
+int main() {
+    Graph graph = network();
+    bool passed = earliestArrivals(graph);
+    passed &= profiles(graph);
+    std::cout << (passed ? "All timetable checks passed" : "Some timetable checks failed") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -18,13 +18,40 @@
  */
 
 #include <iostream>
+#include <cstdlib>
 #include "Reader.h"
 #include "Stop.h"
 #include "Coordinate.h"
 #include "Graph.h"
 #include "Menu.h"
+#include "RouteServer.h"
 
-int main() {
+int main(int argc, char* argv[]) {
+
+    //the compile step reads the dataset once and writes the snapshot the next starts load
+    if (argc > 1 && std::string(argv[1]) == "--compile-snapshot") {
+        Graph network = Database::readNetwork();
+        if (!network.saveSnapshot(Database::SNAPSHOT_PATH, Database::datasetStamp())) {
+            std::cout << "Could not write " << Database::SNAPSHOT_PATH << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << Database::SNAPSHOT_PATH << std::endl;
+        return 0;
+    }
+
+    //the server mode loads the graph once and answers the route requests of many clients over a socket:
+    //"AEDAGrafos --server <port or Unix socket path> [number of threads]"
+    if (argc > 2 && std::string(argv[1]) == "--server") {
+        Database database;
+        RouteServer server(database.map, argc > 3 ? (unsigned) std::atoi(argv[3]) : 0);
+        if (!server.listen(argv[2])) {
+            std::cout << "Could not listen on " << argv[2] << std::endl;
+            return 1;
+        }
+        std::cout << "Listening on " << argv[2] << std::endl;
+        server.run();
+        return 0;
+    }
 
     Menu menu;
     menu.display();